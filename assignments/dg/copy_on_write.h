@@ -0,0 +1,232 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_COPY_ON_WRITE_H_
+#define ASSIGNMENTS_DG_COPY_ON_WRITE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+/**
+ * True if an owner other than p shares p's object. use_count() is a relaxed
+ * load, so when it finds p alone the acquire fence pairs it with the release
+ * by which each other owner let go: their reads of the object happen before
+ * p's owner writes to it or frees it in place.
+ */
+template <typename T>
+inline bool IsShared(const std::shared_ptr<T>& p) {
+  if (p.use_count() > 1) {
+    return true;
+  }
+#if defined(__SANITIZE_THREAD__)
+  // ThreadSanitizer doesn't see fences, an acquire on the count it does see
+  std::shared_ptr<T>{p}.reset();
+#else
+  std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+  return false;
+}
+
+/**
+ * Holds a T that copies of the holder share until one of them writes to it.
+ * Writing through Mutable() to a T that is shared first gives this holder a
+ * copy of its own. T is an allocator aware container, and it is allocated
+ * from the holder's memory resource, as is every copy. A holder with nothing
+ * in it reads as an empty T.
+ */
+template <typename T>
+class CopyOnWrite {
+ public:
+  explicit CopyOnWrite(std::pmr::memory_resource* resource) : resource_{resource} {}
+
+  CopyOnWrite(const CopyOnWrite&) = default;
+
+  CopyOnWrite(CopyOnWrite&&) noexcept = default;
+
+  // Assignment shares other's T, so other must use an equal resource
+  CopyOnWrite& operator=(const CopyOnWrite& other) {
+    shared_ = other.shared_;
+    return *this;
+  }
+
+  CopyOnWrite& operator=(CopyOnWrite&& other) noexcept {
+    shared_ = std::move(other.shared_);
+    return *this;
+  }
+
+  inline const T& operator*() const { return shared_ ? *shared_ : Empty(); }
+
+  inline const T* operator->() const { return &**this; }
+
+  // Returns the T for writing, copying it first if another holder shares it
+  T& Mutable() {
+    std::pmr::polymorphic_allocator<T> alloc{resource_};
+    if (!shared_) {
+      shared_ = std::allocate_shared<T>(alloc);
+    } else if (IsShared(shared_)) {
+      shared_ = std::allocate_shared<T>(alloc, *shared_);
+    }
+    return *shared_;
+  }
+
+  // Drops this holder's share, leaving it empty
+  void Reset() { shared_.reset(); }
+
+  // True if both holders share one T, or are both empty
+  inline bool SharesWith(const CopyOnWrite& other) const { return shared_ == other.shared_; }
+
+  inline std::pmr::memory_resource* GetResource() const { return resource_; }
+
+ private:
+  static const T& Empty() {
+    static const T empty;
+    return empty;
+  }
+
+  std::pmr::memory_resource* resource_;
+  std::shared_ptr<T> shared_;
+};
+
+/**
+ * A slab of Ts addressed by index, kept in pages of 2^PAGE_BITS elements.
+ * Copies of a slab share its page table and pages. Writing to an element
+ * through Mutable() first copies the page table and the element's page if
+ * they are shared, so a copy costs O(1) and each write after it copies at
+ * most one page. Elements never move, so growing the slab keeps references
+ * to them valid.
+ *
+ * Pages are copied with T(const T&, std::pmr::memory_resource*), which T
+ * must provide.
+ */
+template <typename T, std::size_t PAGE_BITS = 4>
+class PagedSlab {
+ public:
+  explicit PagedSlab(std::pmr::memory_resource* resource) : pages_{resource} {}
+
+  PagedSlab(const PagedSlab&) = default;
+
+  PagedSlab(PagedSlab&& other) noexcept
+    : pages_{std::move(other.pages_)}, table_{std::exchange(other.table_, nullptr)},
+      size_{std::exchange(other.size_, 0)} {}
+
+  // Assignment shares other's pages, so other must use an equal resource
+  PagedSlab& operator=(const PagedSlab& other) {
+    pages_ = other.pages_;
+    table_ = other.table_;
+    size_ = other.size_;
+    return *this;
+  }
+
+  PagedSlab& operator=(PagedSlab&& other) noexcept {
+    pages_ = std::move(other.pages_);
+    table_ = std::exchange(other.table_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  inline std::size_t Size() const { return size_; }
+
+  // True if both slabs share one page table, and so hold the same elements
+  inline bool SharesWith(const PagedSlab& other) const { return pages_.SharesWith(other.pages_); }
+
+  inline const T& operator[](std::size_t i) const {
+    return table_[i >> PAGE_BITS]->items[i & MASK];
+  }
+
+  // Returns element i for writing. References to it from before may point
+  // into a page that has since been copied.
+  T& Mutable(std::size_t i) {
+    auto& page = MutableTable()[i >> PAGE_BITS];
+    if (IsShared(page)) {
+      page = CopyPage(*page);
+    }
+    return page->items[i & MASK];
+  }
+
+  template <typename... Args>
+  void EmplaceBack(Args&&... args) {
+    auto& pages = MutableTable();
+    if ((size_ & MASK) == 0) {
+      pages.push_back(NewPage());
+      table_ = pages.data();
+    } else if (IsShared(pages.back())) {
+      pages.back() = CopyPage(*pages.back());
+    }
+    auto& page = *pages.back();
+    new (&page.items[page.size]) T(std::forward<Args>(args)...);
+    ++page.size;
+    ++size_;
+  }
+
+  void Reserve(std::size_t n) {
+    MutableTable().reserve((n + MASK) >> PAGE_BITS);
+    table_ = pages_->data();
+  }
+
+  // Drops this slab's share of the pages, leaving it empty
+  void Clear() {
+    pages_.Reset();
+    table_ = nullptr;
+    size_ = 0;
+  }
+
+  inline std::pmr::memory_resource* GetResource() const { return pages_.GetResource(); }
+
+ private:
+  static constexpr std::size_t MASK = (std::size_t{1} << PAGE_BITS) - 1;
+
+  // items[0, size) are constructed
+  struct Page {
+    Page() {}
+
+    Page(const Page&) = delete;
+
+    Page& operator=(const Page&) = delete;
+
+    ~Page() {
+      for (std::size_t i = 0; i < size; ++i) {
+        items[i].~T();
+      }
+    }
+
+    std::size_t size = 0;
+    union {
+      T items[MASK + 1];
+    };
+  };
+
+  std::pmr::vector<std::shared_ptr<Page>>& MutableTable() {
+    auto& pages = pages_.Mutable();
+    table_ = pages.data();
+    return pages;
+  }
+
+  std::shared_ptr<Page> NewPage() {
+    return std::allocate_shared<Page>(std::pmr::polymorphic_allocator<Page>{GetResource()});
+  }
+
+  std::shared_ptr<Page> CopyPage(const Page& from) {
+    auto page = NewPage();
+    for (; page->size < from.size; ++page->size) {
+      new (&page->items[page->size]) T(from.items[page->size], GetResource());
+    }
+    return page;
+  }
+
+  CopyOnWrite<std::pmr::vector<std::shared_ptr<Page>>> pages_;
+  // The data of *pages_, so reading an element takes two loads
+  const std::shared_ptr<Page>* table_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_COPY_ON_WRITE_H_
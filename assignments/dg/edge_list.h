@@ -0,0 +1,400 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_EDGE_LIST_H_
+#define ASSIGNMENTS_DG_EDGE_LIST_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+/**
+ * Positions of a node's edges in order of weight, ties in order of position.
+ * Sort() may be called through const copies of a graph that share one edge
+ * list, from any number of threads: the first caller sorts, the others wait
+ * for it, and the sorted positions are published with release and acquire.
+ * Reset() is a change to the edges, so it needs the list to itself.
+ */
+class WeightOrder {
+ public:
+  explicit WeightOrder(std::pmr::memory_resource* resource) : byWeight_(resource) {}
+
+  WeightOrder(const WeightOrder&) = delete;
+
+  WeightOrder& operator=(const WeightOrder&) = delete;
+
+  // Moving is a change to both lists, so neither can be sorting
+  WeightOrder& operator=(WeightOrder&& other) noexcept {
+    byWeight_ = std::move(other.byWeight_);
+    state_.store(other.state_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    other.Reset();
+    return *this;
+  }
+
+  // Position of the i-th lightest edge. Only valid after Sort().
+  inline std::size_t operator[](std::size_t i) const { return byWeight_[i]; }
+
+  /**
+   * Sorts positions [0, n) unless they are sorted since the last Reset()
+   *
+   * @param less - less(i, j) is true if the weight at i is less than at j
+   */
+  template <typename Less>
+  void Sort(std::size_t n, Less less) const {
+    if (state_.load(std::memory_order_acquire) == SORTED) {
+      return;
+    }
+    auto expected = UNSORTED;
+    if (state_.compare_exchange_strong(expected, SORTING, std::memory_order_acquire)) {
+      byWeight_.resize(n);
+      std::iota(byWeight_.begin(), byWeight_.end(), 0);
+      std::stable_sort(byWeight_.begin(), byWeight_.end(), less);
+      state_.store(SORTED, std::memory_order_release);
+      return;
+    }
+    while (state_.load(std::memory_order_acquire) != SORTED) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Drops the order, keeping its memory for the next Sort()
+  inline void Reset() { state_.store(UNSORTED, std::memory_order_relaxed); }
+
+  // Drops the order and gives the memory back to the resource
+  void Release() {
+    Reset();
+    byWeight_.clear();
+    byWeight_.shrink_to_fit();
+  }
+
+ private:
+  enum State : std::uint8_t { UNSORTED, SORTING, SORTED };
+
+  mutable std::pmr::vector<std::uint32_t> byWeight_;
+  mutable std::atomic<State> state_{UNSORTED};
+};
+
+/**
+ * The out-edges of one node, each a destination id and a weight, addressed
+ * by position. Trivially copyable weights are kept in their own column next
+ * to a column of destinations, so a run of weights is one contiguous array
+ * that can be copied or scanned with vector instructions. Other weights are
+ * kept next to their destination, so each edge is one element and moving an
+ * edge moves one object.
+ *
+ * Next to the edges, which are kept in whatever order the graph needs, is a
+ * WeightOrder of their positions. It is a cache, sorted the first time it is
+ * asked for after the edges change, even through a const EdgeList, and every
+ * change drops it.
+ */
+template <typename Id, typename E, bool Split = std::is_trivially_copyable_v<E>>
+class EdgeList;
+
+// Structure of arrays, for trivially copyable weights
+template <typename Id, typename E>
+class EdgeList<Id, E, true> {
+ public:
+  struct Edge {
+    Id dst;
+    E weight;
+  };
+
+  // Steps through weights in place, see Graph::weight_iterator
+  using weight_cursor = const E*;
+
+  explicit EdgeList(std::pmr::memory_resource* resource)
+    : dsts_(resource), weights_(resource), byWeight_(resource) {}
+
+  EdgeList(const EdgeList& other, std::pmr::memory_resource* resource)
+    : dsts_(other.dsts_, resource), weights_(other.weights_, resource), byWeight_(resource) {}
+
+  inline std::size_t Size() const { return dsts_.size(); }
+
+  inline bool Empty() const { return dsts_.empty(); }
+
+  inline Id Dst(std::size_t i) const { return dsts_[i]; }
+
+  inline const E& Weight(std::size_t i) const { return weights_[i]; }
+
+  inline weight_cursor WeightCursor(std::size_t i) const { return weights_.data() + i; }
+
+  static inline const E& WeightOf(weight_cursor cursor) { return *cursor; }
+
+  std::vector<E> Weights(std::size_t first, std::size_t last) const {
+    return {weights_.begin() + first, weights_.begin() + last};
+  }
+
+  void Reserve(std::size_t n) {
+    dsts_.reserve(n);
+    weights_.reserve(n);
+  }
+
+  // Position of the i-th lightest edge, ties in order of position. Only
+  // valid after SortByWeight().
+  inline std::size_t ByWeight(std::size_t i) const { return byWeight_[i]; }
+
+  // Sorts the weight order if the edges changed since it was last sorted
+  void SortByWeight() const {
+    byWeight_.Sort(dsts_.size(), [this](std::uint32_t i, std::uint32_t j) {
+      return weights_[i] < weights_[j];
+    });
+  }
+
+  // Drops every edge and gives the memory back to the resource
+  void Release() {
+    dsts_.clear();
+    dsts_.shrink_to_fit();
+    weights_.clear();
+    weights_.shrink_to_fit();
+    byWeight_.Release();
+  }
+
+  void PushBack(Id dst, const E& weight) {
+    byWeight_.Reset();
+    dsts_.push_back(dst);
+    weights_.push_back(weight);
+  }
+
+  // Replaces the edges with other's, passing each destination through map.
+  // The weight column is copied in one go.
+  template <typename Map>
+  void AssignMapped(const EdgeList& other, Map map) {
+    byWeight_.Reset();
+    dsts_.resize(other.dsts_.size());
+    for (std::size_t i = 0; i < dsts_.size(); ++i) {
+      dsts_[i] = map(other.dsts_[i]);
+    }
+    weights_.assign(other.weights_.begin(), other.weights_.end());
+  }
+
+  // Replaces the edges with the n edges in the columns dsts and weights
+  void Assign(const Id* dsts, const E* weights, std::size_t n) {
+    byWeight_.Reset();
+    dsts_.assign(dsts, dsts + n);
+    weights_.assign(weights, weights + n);
+  }
+
+  void Insert(std::size_t pos, Id dst, const E& weight) {
+    byWeight_.Reset();
+    dsts_.insert(dsts_.begin() + pos, dst);
+    weights_.insert(weights_.begin() + pos, weight);
+  }
+
+  void Erase(std::size_t first, std::size_t last) {
+    byWeight_.Reset();
+    dsts_.erase(dsts_.begin() + first, dsts_.begin() + last);
+    weights_.erase(weights_.begin() + first, weights_.begin() + last);
+  }
+
+  // Moves [middle, last) in front of [first, middle)
+  void Rotate(std::size_t first, std::size_t middle, std::size_t last) {
+    byWeight_.Reset();
+    std::rotate(dsts_.begin() + first, dsts_.begin() + middle, dsts_.begin() + last);
+    std::rotate(weights_.begin() + first, weights_.begin() + middle, weights_.begin() + last);
+  }
+
+  // Keeps the edges at positions where keep is true, in order
+  template <typename Keep>
+  void Filter(Keep keep) {
+    byWeight_.Reset();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < dsts_.size(); ++i) {
+      if (keep(i)) {
+        dsts_[kept] = dsts_[i];
+        weights_[kept] = weights_[i];
+        ++kept;
+      }
+    }
+    dsts_.erase(dsts_.begin() + kept, dsts_.end());
+    weights_.erase(weights_.begin() + kept, weights_.end());
+  }
+
+  /**
+   * Merges sorted, new edges into the sorted edges from the back, so each
+   * edge is moved at most once
+   *
+   * @param added - sorted edges, none equal to an existing edge
+   * @param less - less(dst1, weight1, dst2, weight2) orders two edges
+   */
+  template <typename Less>
+  void Merge(const std::pmr::vector<Edge>& added, Less less) {
+    if (added.empty()) {
+      return;
+    }
+    byWeight_.Reset();
+    auto i = dsts_.size();
+    auto j = added.size();
+    dsts_.resize(i + j);
+    weights_.resize(i + j, added.front().weight);
+    for (auto k = dsts_.size(); j > 0;) {
+      --k;
+      if (i > 0 && less(added[j - 1].dst, added[j - 1].weight, dsts_[i - 1], weights_[i - 1])) {
+        --i;
+        dsts_[k] = dsts_[i];
+        weights_[k] = weights_[i];
+      } else {
+        --j;
+        dsts_[k] = added[j].dst;
+        weights_[k] = added[j].weight;
+      }
+    }
+  }
+
+ private:
+  std::pmr::vector<Id> dsts_;
+  std::pmr::vector<E> weights_;
+  // Reset by every change
+  WeightOrder byWeight_;
+};
+
+// Array of structures, for weights that have to be moved with care
+template <typename Id, typename E>
+class EdgeList<Id, E, false> {
+ public:
+  struct Edge {
+    Id dst;
+    E weight;
+  };
+
+  // Steps through weights in place, see Graph::weight_iterator
+  using weight_cursor = typename std::pmr::vector<Edge>::const_iterator;
+
+  explicit EdgeList(std::pmr::memory_resource* resource) : edges_(resource), byWeight_(resource) {}
+
+  EdgeList(const EdgeList& other, std::pmr::memory_resource* resource)
+    : edges_(other.edges_, resource), byWeight_(resource) {}
+
+  inline std::size_t Size() const { return edges_.size(); }
+
+  inline bool Empty() const { return edges_.empty(); }
+
+  inline Id Dst(std::size_t i) const { return edges_[i].dst; }
+
+  inline const E& Weight(std::size_t i) const { return edges_[i].weight; }
+
+  inline weight_cursor WeightCursor(std::size_t i) const { return edges_.begin() + i; }
+
+  static inline const E& WeightOf(weight_cursor cursor) { return cursor->weight; }
+
+  std::vector<E> Weights(std::size_t first, std::size_t last) const {
+    std::vector<E> weights;
+    weights.reserve(last - first);
+    for (auto i = first; i < last; ++i) {
+      weights.push_back(edges_[i].weight);
+    }
+    return weights;
+  }
+
+  void Reserve(std::size_t n) { edges_.reserve(n); }
+
+  // See the split EdgeList
+  inline std::size_t ByWeight(std::size_t i) const { return byWeight_[i]; }
+
+  void SortByWeight() const {
+    byWeight_.Sort(edges_.size(), [this](std::uint32_t i, std::uint32_t j) {
+      return edges_[i].weight < edges_[j].weight;
+    });
+  }
+
+  // Drops every edge and gives the memory back to the resource
+  void Release() {
+    edges_.clear();
+    edges_.shrink_to_fit();
+    byWeight_.Release();
+  }
+
+  void PushBack(Id dst, const E& weight) {
+    byWeight_.Reset();
+    edges_.push_back(Edge{dst, weight});
+  }
+
+  // Replaces the edges with other's, passing each destination through map
+  template <typename Map>
+  void AssignMapped(const EdgeList& other, Map map) {
+    byWeight_.Reset();
+    edges_.clear();
+    edges_.reserve(other.edges_.size());
+    for (const auto& edge : other.edges_) {
+      edges_.push_back(Edge{map(edge.dst), edge.weight});
+    }
+  }
+
+  // Replaces the edges with the n edges in the columns dsts and weights
+  void Assign(const Id* dsts, const E* weights, std::size_t n) {
+    byWeight_.Reset();
+    edges_.clear();
+    edges_.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      edges_.push_back(Edge{dsts[i], weights[i]});
+    }
+  }
+
+  void Insert(std::size_t pos, Id dst, const E& weight) {
+    byWeight_.Reset();
+    edges_.insert(edges_.begin() + pos, Edge{dst, weight});
+  }
+
+  void Erase(std::size_t first, std::size_t last) {
+    byWeight_.Reset();
+    edges_.erase(edges_.begin() + first, edges_.begin() + last);
+  }
+
+  // Moves [middle, last) in front of [first, middle)
+  void Rotate(std::size_t first, std::size_t middle, std::size_t last) {
+    byWeight_.Reset();
+    std::rotate(edges_.begin() + first, edges_.begin() + middle, edges_.begin() + last);
+  }
+
+  // Keeps the edges at positions where keep is true, in order
+  template <typename Keep>
+  void Filter(Keep keep) {
+    byWeight_.Reset();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < edges_.size(); ++i) {
+      if (keep(i)) {
+        // Moving a string onto itself would empty it
+        if (kept != i) {
+          edges_[kept] = std::move(edges_[i]);
+        }
+        ++kept;
+      }
+    }
+    edges_.erase(edges_.begin() + kept, edges_.end());
+  }
+
+  /**
+   * Merges sorted, new edges into the sorted edges
+   *
+   * @param added - sorted edges, none equal to an existing edge
+   * @param less - less(dst1, weight1, dst2, weight2) orders two edges
+   */
+  template <typename Less>
+  void Merge(const std::pmr::vector<Edge>& added, Less less) {
+    byWeight_.Reset();
+    auto mid = edges_.size();
+    edges_.insert(edges_.end(), added.begin(), added.end());
+    std::inplace_merge(edges_.begin(), edges_.begin() + mid, edges_.end(),
+                       [&less](const Edge& e1, const Edge& e2) {
+                         return less(e1.dst, e1.weight, e2.dst, e2.weight);
+                       });
+  }
+
+ private:
+  std::pmr::vector<Edge> edges_;
+  // Reset by every change
+  WeightOrder byWeight_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_EDGE_LIST_H_
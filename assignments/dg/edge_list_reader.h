@@ -0,0 +1,256 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_EDGE_LIST_READER_H_
+#define ASSIGNMENTS_DG_EDGE_LIST_READER_H_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+struct EdgeListOptions {
+  // Separates the fields of a line, 0 for any run of spaces, tabs and commas
+  char separator = 0;
+  // Threads to parse on, 0 for one per hardware thread
+  unsigned threads = 0;
+  // Bytes read from the file at a time
+  std::size_t chunkSize = 1 << 24;
+};
+
+/**
+ * Parses one field of an edge list into value without a locale, returning
+ * false if the whole field isn't a T. Arithmetic values are read by
+ * std::from_chars, bools as 1 or 0, and character types as one character.
+ * Types made from a string_view get the field as it is, and anything else
+ * falls back to an istream.
+ *
+ * @param field - text of the field, without separators
+ * @param value - set to the parsed value
+ */
+template <typename T>
+bool parseField(std::string_view field, T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    value = field == "1";
+    return field == "1" || field == "0";
+  } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                       std::is_same_v<T, unsigned char>) {
+    value = static_cast<T>(field.empty() ? 0 : field.front());
+    return field.size() == 1;
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    auto res = std::from_chars(field.data(), field.data() + field.size(), value);
+    return res.ec == std::errc() && res.ptr == field.data() + field.size();
+  } else if constexpr (std::is_constructible_v<T, std::string_view>) {
+    value = T(field);
+    return true;
+  } else {
+    std::istringstream is{std::string{field}};
+    return static_cast<bool>(is >> value) && (is >> std::ws).eof();
+  }
+}
+
+/**
+ * Parses the `src dst weight` lines of text, appending an edge to edges for
+ * each. Blank lines and lines starting with # are skipped, and a \r before
+ * the end of a line is dropped. Throws std::runtime_error on a line that
+ * isn't three fields of the right types.
+ *
+ * @param text - whole lines of an edge list
+ * @param separator - see EdgeListOptions
+ * @param edges - where the parsed edges are added
+ */
+template <typename N, typename E>
+void parseEdgeLines(std::string_view text, char separator,
+                    std::vector<std::tuple<N, N, E>>& edges) {
+  auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == ','; };
+  while (!text.empty()) {
+    auto end = text.find('\n');
+    auto line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    // Splits the line into fields, only keeping the first three
+    std::string_view fields[3];
+    std::size_t count = 0;
+    if (separator == 0) {
+      for (std::size_t pos = 0; count <= 3;) {
+        while (pos < line.size() && isSpace(line[pos])) {
+          ++pos;
+        }
+        if (pos == line.size()) {
+          break;
+        }
+        auto start = pos;
+        while (pos < line.size() && !isSpace(line[pos])) {
+          ++pos;
+        }
+        if (count < 3) {
+          fields[count] = line.substr(start, pos - start);
+        }
+        ++count;
+      }
+      // Only spaces
+      if (count == 0) {
+        continue;
+      }
+    } else {
+      for (std::size_t pos = 0; count <= 3; ++count) {
+        auto fieldEnd = std::min(line.find(separator, pos), line.size());
+        if (count < 3) {
+          fields[count] = line.substr(pos, fieldEnd - pos);
+        }
+        if (fieldEnd == line.size()) {
+          ++count;
+          break;
+        }
+        pos = fieldEnd + 1;
+      }
+    }
+
+    std::tuple<N, N, E> edge;
+    if (count != 3 || !parseField(fields[0], std::get<0>(edge)) ||
+        !parseField(fields[1], std::get<1>(edge)) || !parseField(fields[2], std::get<2>(edge))) {
+      throw std::runtime_error("Cannot read edge list line: " + std::string{line});
+    }
+    edges.push_back(std::move(edge));
+  }
+}
+
+/**
+ * Reads a graph from a text file with a `src dst weight` line per edge. The
+ * file is read in chunks, each split at line ends into one piece per thread,
+ * and the pieces are parsed in parallel with parseEdgeLines. Each thread then
+ * sorts its own edges, the sorted runs are merged in parallel rounds, and the
+ * graph is built from them with the sorted_unique constructor, so nothing is
+ * inserted one edge at a time. Duplicate edges are kept once. Throws
+ * std::runtime_error if the file can't be read or a line can't be parsed.
+ *
+ * @param path - edge list file
+ * @param options - separator, threads and chunk size
+ * @param resource - memory resource for the graph's storage
+ */
+template <typename N, typename E>
+Graph<N, E> readEdgeList(const std::string& path, const EdgeListOptions& options = {},
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+  using Edges = std::vector<std::tuple<N, N, E>>;
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{std::fopen(path.c_str(), "rb"),
+                                                       &std::fclose};
+  if (!file) {
+    throw std::runtime_error("Cannot read an edge list from a path that can't be read");
+  }
+  std::setvbuf(file.get(), nullptr, _IONBF, 0);
+  auto threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+  threads = std::max(threads, 1u);
+  auto chunkSize = std::max<std::size_t>(options.chunkSize, 1);
+
+  std::vector<Edges> parts(threads);
+  // buffer[0, kept) is the partial line left over from the last chunk
+  std::vector<char> buffer;
+  std::size_t kept = 0;
+  for (bool more = true; more;) {
+    buffer.resize(kept + chunkSize);
+    auto got = std::fread(buffer.data() + kept, 1, chunkSize, file.get());
+    if (got < chunkSize) {
+      if (std::ferror(file.get())) {
+        throw std::runtime_error("Cannot read an edge list from a path that can't be read");
+      }
+      more = false;
+    }
+    std::string_view text{buffer.data(), kept + got};
+    // Only whole lines are parsed until the end of the file
+    auto whole = more ? text.rfind('\n') + 1 : text.size();
+    text = text.substr(0, whole);
+
+    // One piece per thread, each ending at the end of a line
+    std::vector<std::future<void>> parsing;
+    for (unsigned t = 0; t < threads && !text.empty(); ++t) {
+      auto end = t + 1 == threads ? text.size() : text.size() / (threads - t);
+      end = std::min(text.size(), text.find('\n', end));
+      end += end < text.size();
+      auto piece = text.substr(0, end);
+      text.remove_prefix(end);
+      if (t + 1 == threads || text.empty()) {
+        // The last piece is parsed on this thread
+        parseEdgeLines(piece, options.separator, parts[t]);
+      } else {
+        parsing.push_back(std::async(std::launch::async, [&, piece, t] {
+          parseEdgeLines(piece, options.separator, parts[t]);
+        }));
+      }
+    }
+    for (auto& f : parsing) {
+      f.get();
+    }
+
+    kept = kept + got - whole;
+    std::memmove(buffer.data(), buffer.data() + whole, kept);
+  }
+
+  // Each part is sorted where it was parsed, then pairs of sorted runs are
+  // merged until one is left
+  std::vector<std::future<void>> sorting;
+  for (std::size_t t = 1; t < parts.size(); ++t) {
+    sorting.push_back(std::async(std::launch::async, [&parts, t] {
+      std::sort(parts[t].begin(), parts[t].end());
+    }));
+  }
+  std::sort(parts[0].begin(), parts[0].end());
+  for (auto& f : sorting) {
+    f.get();
+  }
+  while (parts.size() > 1) {
+    std::vector<Edges> merged((parts.size() + 1) / 2);
+    std::vector<std::future<void>> merging;
+    for (std::size_t i = 0; i < merged.size(); ++i) {
+      merging.push_back(std::async(std::launch::async, [&parts, &merged, i] {
+        if (2 * i + 1 == parts.size()) {
+          merged[i] = std::move(parts[2 * i]);
+          return;
+        }
+        auto& first = parts[2 * i];
+        auto& second = parts[2 * i + 1];
+        merged[i].reserve(first.size() + second.size());
+        std::merge(std::make_move_iterator(first.begin()), std::make_move_iterator(first.end()),
+                   std::make_move_iterator(second.begin()),
+                   std::make_move_iterator(second.end()), std::back_inserter(merged[i]));
+        Edges{}.swap(first);
+        Edges{}.swap(second);
+      }));
+    }
+    for (auto& f : merging) {
+      f.get();
+    }
+    parts = std::move(merged);
+  }
+
+  auto& edges = parts.front();
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  return Graph<N, E>{sorted_unique, edges.cbegin(), edges.cend(), resource};
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_EDGE_LIST_READER_H_
@@ -0,0 +1,120 @@
+/*
+Copyright [2019] Clive Chen, Vaishnavi Bapat
+zid - z5166040, z5075858
+
+  == Explanation and rational of testing ==
+
+ readEdgeList splits a file into chunks and each chunk into one piece per
+ thread, so each test reads the same file in one piece and in many small
+ ones, on one thread and on several, and checks every way gives the graph
+ built with InsertEdge (which is tested in graph_test.cpp). The separators,
+ comments and line endings an edge feed might use are mixed into one file,
+ and lines that aren't edges have to be reported rather than skipped.
+*/
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/edge_list_reader.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph.tpp"
+#include "catch.h"
+
+namespace {
+
+std::string writeFile(const std::string& name, const std::string& text) {
+  std::string path = std::filesystem::temp_directory_path() / ("edge_list_test_" + name);
+  std::ofstream{path, std::ios::binary} << text;
+  return path;
+}
+
+// Every way of splitting the file up for parsing
+std::vector<gdwg::EdgeListOptions> splits(char separator) {
+  std::vector<gdwg::EdgeListOptions> res;
+  for (unsigned threads : {1u, 3u}) {
+    for (std::size_t chunkSize : {std::size_t{1} << 20, std::size_t{7}}) {
+      res.push_back({separator, threads, chunkSize});
+    }
+  }
+  return res;
+}
+
+}  // namespace
+
+SCENARIO("Reading an edge list with mixed separators") {
+  GIVEN("an edge list with comments, blank lines, duplicates and CRLF line ends") {
+    auto path = writeFile("mixed.txt",
+                          "# src dst weight\n"
+                          "1 2 0.5\n"
+                          "1\t2\t-3\r\n"
+                          "\n"
+                          "2,3,1e3\n"
+                          "   \n"
+                          "3  1 , 7\n"
+                          "1 2 0.5\n"
+                          "40 40 2");
+    gdwg::Graph<int, double> expected;
+    for (int node : {1, 2, 3, 40}) {
+      expected.InsertNode(node);
+    }
+    expected.InsertEdge(1, 2, 0.5);
+    expected.InsertEdge(1, 2, -3);
+    expected.InsertEdge(2, 3, 1000);
+    expected.InsertEdge(3, 1, 7);
+    expected.InsertEdge(40, 40, 2);
+
+    WHEN("it is read in pieces of every size, on one thread and several") {
+      THEN("each way gives the graph with every edge inserted once") {
+        for (const auto& options : splits(0)) {
+          CHECK(gdwg::readEdgeList<int, double>(path, options) == expected);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Reading an edge list with a separator of its own") {
+  GIVEN("an edge list of comma separated names with spaces in them") {
+    auto path = writeFile("names.csv",
+                          "new york,boston,3\n"
+                          "boston,new york,4\n"
+                          "san jose,boston,3\n");
+
+    WHEN("it is read with commas as the separator") {
+      THEN("the names keep their spaces") {
+        for (const auto& options : splits(',')) {
+          auto g = gdwg::readEdgeList<std::string, int>(path, options);
+          CHECK(g.GetNodes() == std::vector<std::string>{"boston", "new york", "san jose"});
+          CHECK(g.GetWeights("new york", "boston") == std::vector<int>{3});
+          CHECK(g.IsConnected("san jose", "boston"));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Reading an edge list that isn't one") {
+  GIVEN("edge lists with a bad line") {
+    std::vector<std::string> bad{"1 2\n", "1 2 3 4\n", "1 x 3\n", "1 2 3.5\n",
+                                 "99999999999 1 2\n"};
+
+    THEN("the bad line is reported, however the file is split up") {
+      for (const auto& line : bad) {
+        auto path = writeFile("bad.txt", "1 2 3\n5 6 7\n" + line + "8 9 10\n");
+        for (const auto& options : splits(0)) {
+          CHECK_THROWS_AS((gdwg::readEdgeList<int, int>(path, options)), std::runtime_error);
+        }
+      }
+    }
+  }
+
+  GIVEN("a path with no file") {
+    THEN("it can't be read") {
+      CHECK_THROWS_AS((gdwg::readEdgeList<int, int>("/nonexistent/edges.txt")),
+                      std::runtime_error);
+    }
+  }
+}
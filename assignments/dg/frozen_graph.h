@@ -0,0 +1,143 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_FROZEN_GRAPH_H_
+#define ASSIGNMENTS_DG_FROZEN_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/view.h"
+
+namespace gdwg {
+
+/**
+ * Read-only snapshot of a Graph in compressed sparse row (CSR) layout.
+ *
+ * Nodes are numbered 0..V-1 in increasing order of value. The out-edges of
+ * node i are the positions [offsets_[i], offsets_[i + 1]) of the contiguous
+ * dsts_ and weights_ arrays, sorted by destination and then weight. Since ids
+ * follow value order, this is also the order Graph iterates its edges in.
+ */
+template <typename N, typename E>
+class FrozenGraph {
+ public:
+  using NodeId = std::uint32_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = std::tuple<N*, N*, E*>;
+    using difference_type = int;
+
+    reference operator*() const;
+
+    const_iterator& operator++();
+
+    const const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    const_iterator& operator--();
+
+    const const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.graph_ == rhs.graph_ && lhs.edge_ == rhs.edge_;
+    }
+
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class FrozenGraph;
+
+    const FrozenGraph* graph_;
+    // source node of edge_, kept in step with it so neither moves backwards
+    NodeId src_;
+    std::size_t edge_;
+
+    const_iterator(const FrozenGraph* graph, NodeId src, std::size_t edge)
+      : graph_{graph}, src_{src}, edge_{edge} {}
+  };
+
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  FrozenGraph() : offsets_{0} {}
+
+  explicit FrozenGraph(const Graph<N, E>& g);
+
+  bool IsNode(const N& val) const;
+
+  bool IsConnected(const N& src, const N& dst) const;
+
+  std::vector<N> GetNodes() const;
+
+  std::vector<N> GetConnected(const N& src) const;
+
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+
+  // Index based access for traversal algorithms
+
+  inline std::size_t NodeCount() const { return nodes_.size(); }
+
+  inline std::size_t EdgeCount() const { return dsts_.size(); }
+
+  NodeId GetId(const N& val) const;
+
+  inline const N& GetValue(NodeId id) const { return nodes_[id]; }
+
+  inline View<typename std::vector<NodeId>::const_iterator> GetOutDestinations(NodeId id) const {
+    return {dsts_.begin() + offsets_[id], dsts_.begin() + offsets_[id + 1]};
+  }
+
+  inline View<typename std::vector<E>::const_iterator> GetOutWeights(NodeId id) const {
+    return {weights_.begin() + offsets_[id], weights_.begin() + offsets_[id + 1]};
+  }
+
+  const_iterator cbegin() const;
+
+  const_iterator cend() const { return {this, static_cast<NodeId>(nodes_.size()), dsts_.size()}; }
+
+  const_reverse_iterator crbegin() const { return const_reverse_iterator{cend()}; }
+
+  const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
+
+  inline const_iterator begin() const { return cbegin(); }
+
+  inline const_iterator end() const { return cend(); }
+
+  inline const_reverse_iterator rbegin() const { return crbegin(); }
+
+  inline const_reverse_iterator rend() const { return crend(); }
+
+ private:
+  // Returns NodeCount() if val is not a node
+  NodeId FindId(const N& val) const;
+
+  // Range of src's out-edges going to dst, as positions in dsts_
+  std::pair<std::size_t, std::size_t> EdgeRange(NodeId src, NodeId dst) const;
+
+  std::vector<N> nodes_;
+  std::vector<std::size_t> offsets_;
+  std::vector<NodeId> dsts_;
+  std::vector<E> weights_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_FROZEN_GRAPH_H_
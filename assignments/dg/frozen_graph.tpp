@@ -0,0 +1,228 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+
+#include "assignments/dg/frozen_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Constructor
+ * Lays out the nodes and edges of g in CSR form. Node ids follow the order of
+ * g's (sorted) node list and each node's edges are appended in the order g
+ * keeps them, so no sorting is needed.
+ *
+ * @param g - graph being frozen
+ */
+template <typename N, typename E>
+gdwg::FrozenGraph<N, E>::FrozenGraph(const gdwg::Graph<N, E>& g) {
+  // Graph ids are slab slots, frozenId maps them to positions in nodes_
+  std::vector<NodeId> frozenId(g.nodes_.Size());
+  nodes_.reserve(g.nodeList_->size());
+  for (auto id : *g.nodeList_) {
+    frozenId[id] = nodes_.size();
+    nodes_.push_back(g.nodes_[id].GetValue());
+  }
+
+  offsets_.reserve(nodes_.size() + 1);
+  offsets_.push_back(0);
+  for (auto id : *g.nodeList_) {
+    const auto& edges = g.nodes_[id].GetEdges();
+    for (std::size_t i = 0; i < edges.Size(); ++i) {
+      dsts_.push_back(frozenId[edges.Dst(i)]);
+      weights_.push_back(edges.Weight(i));
+    }
+    offsets_.push_back(dsts_.size());
+  }
+}
+
+/**
+ * Returns a read-only CSR snapshot of the graph. Later changes to the graph
+ * are not reflected in the snapshot.
+ */
+template <typename N, typename E>
+gdwg::FrozenGraph<N, E> gdwg::Graph<N, E>::Freeze() const {
+  return FrozenGraph<N, E>{*this};
+}
+
+/**
+ * Binary search for the id of val
+ *
+ * @param val - value of potential node
+ * @return the id of val, or NodeCount() if val is not a node
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::NodeId gdwg::FrozenGraph<N, E>::FindId(const N& val) const {
+  auto it = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (it == nodes_.end() || val < *it) {
+    return nodes_.size();
+  }
+  return it - nodes_.begin();
+}
+
+/**
+ * Returns the positions [first, last) of the edges src → dst. Since the edges
+ * of a node are sorted by destination this is a binary search.
+ *
+ * @param src - id of source node
+ * @param dst - id of destination node
+ */
+template <typename N, typename E>
+std::pair<std::size_t, std::size_t> gdwg::FrozenGraph<N, E>::EdgeRange(NodeId src,
+                                                                       NodeId dst) const {
+  auto first = dsts_.begin() + offsets_[src];
+  auto last = dsts_.begin() + offsets_[src + 1];
+  auto range = std::equal_range(first, last, dst);
+  return {range.first - dsts_.begin(), range.second - dsts_.begin()};
+}
+
+/**
+ * Returns the id of the node with value val. Ids are contiguous from 0 in
+ * increasing order of value.
+ *
+ * @param val - value of the node
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::NodeId gdwg::FrozenGraph<N, E>::GetId(const N& val) const {
+  auto id = FindId(val);
+  if (id == nodes_.size()) {
+    throw std::out_of_range("Cannot call FrozenGraph::GetId if val doesn't exist in the graph");
+  }
+  return id;
+}
+
+/**
+ * Returns true if a node with value val exists in the graph and false
+ * otherwise.
+ *
+ * @param val - value of potential node
+ */
+template <typename N, typename E>
+bool gdwg::FrozenGraph<N, E>::IsNode(const N& val) const {
+  return FindId(val) != nodes_.size();
+}
+
+/**
+ * Returns true if the edge src → dst exists in the graph and false otherwise.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ */
+template <typename N, typename E>
+bool gdwg::FrozenGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto srcId = FindId(src);
+  auto dstId = FindId(dst);
+  if (srcId == nodes_.size() || dstId == nodes_.size()) {
+    throw std::runtime_error("Cannot call FrozenGraph::IsConnected if src or dst node don't "
+                             "exist in the graph");
+  }
+  auto range = EdgeRange(srcId, dstId);
+  return range.first != range.second;
+}
+
+/**
+ * Returns a vector of all nodes in the graph, sorted by increasing order of
+ * node.
+ */
+template <typename N, typename E>
+std::vector<N> gdwg::FrozenGraph<N, E>::GetNodes() const {
+  return nodes_;
+}
+
+/**
+ * Returns a vector of the nodes connected to src by an outgoing edge, sorted
+ * by increasing order of node.
+ *
+ * @param src - source node
+ */
+template <typename N, typename E>
+std::vector<N> gdwg::FrozenGraph<N, E>::GetConnected(const N& src) const {
+  auto srcId = FindId(src);
+  if (srcId == nodes_.size()) {
+    throw std::out_of_range("Cannot call FrozenGraph::GetConnected if src doesn't exist in the "
+                            "graph");
+  }
+
+  std::vector<N> res;
+  auto dsts = GetOutDestinations(srcId);
+  for (auto dst = dsts.begin(); dst != dsts.end(); ++dst) {
+    // Parallel edges share a destination, only report it once
+    if (dst == dsts.begin() || *dst != *(dst - 1)) {
+      res.push_back(nodes_[*dst]);
+    }
+  }
+  return res;
+}
+
+/**
+ * Returns a vector of the weights of edges src → dst, sorted by increasing
+ * order of edge.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ */
+template <typename N, typename E>
+std::vector<E> gdwg::FrozenGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto srcId = FindId(src);
+  auto dstId = FindId(dst);
+  if (srcId == nodes_.size() || dstId == nodes_.size()) {
+    throw std::out_of_range("Cannot call FrozenGraph::GetWeights if src or dst node don't exist"
+                            " in the graph");
+  }
+  auto range = EdgeRange(srcId, dstId);
+  return {weights_.begin() + range.first, weights_.begin() + range.second};
+}
+
+// const_iterator
+
+/**
+ * Returns a const_iterator pointing to the first edge of the graph, or cend()
+ * if the graph has no edges.
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::const_iterator gdwg::FrozenGraph<N, E>::cbegin() const {
+  // Skip over the leading nodes without any outgoing edges
+  NodeId src = 0;
+  while (src < nodes_.size() && offsets_[src + 1] == 0) {
+    ++src;
+  }
+  return {this, src, 0};
+}
+
+/**
+ * Pre-increment Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::const_iterator& gdwg::FrozenGraph<N, E>::const_iterator::
+operator++() {
+  ++edge_;
+  while (src_ < graph_->nodes_.size() && graph_->offsets_[src_ + 1] <= edge_) {
+    ++src_;
+  }
+  return *this;
+}
+
+/**
+ * Pre-decrement Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::const_iterator& gdwg::FrozenGraph<N, E>::const_iterator::
+operator--() {
+  --edge_;
+  while (graph_->offsets_[src_] > edge_) {
+    --src_;
+  }
+  return *this;
+}
+
+/**
+ * * Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::FrozenGraph<N, E>::const_iterator::reference gdwg::FrozenGraph<N, E>::
+const_iterator::operator*() const {
+  return {graph_->nodes_[src_], graph_->nodes_[graph_->dsts_[edge_]], graph_->weights_[edge_]};
+}
@@ -0,0 +1,145 @@
+/*
+Copyright [2019] Clive Chen, Vaishnavi Bapat
+zid - z5166040, z5075858
+
+  == Explanation and rational of testing ==
+
+ A FrozenGraph is only ever built from a Graph, so each test builds a Graph
+ with the public Graph API (which is tested in graph_test.cpp), freezes it and
+ checks that the snapshot answers queries the same way the Graph does. The
+ CSR specific accessors used by traversal algorithms are then checked against
+ the expected ids and edge order.
+*/
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/frozen_graph.h"
+#include "assignments/dg/frozen_graph.tpp"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph.tpp"
+#include "catch.h"
+
+namespace {
+
+gdwg::Graph<std::string, int> makeGraph() {
+  gdwg::Graph<std::string, int> g;
+  g.InsertNode("c");
+  g.InsertNode("d");
+  g.InsertNode("b");
+  g.InsertNode("a");
+  g.InsertNode("e");
+  g.InsertEdge("a", "b", 10);
+  g.InsertEdge("a", "b", 1);
+  g.InsertEdge("a", "d", 4);
+  g.InsertEdge("a", "d", 50);
+  g.InsertEdge("b", "b", 2);
+  g.InsertEdge("c", "b", 3);
+  g.InsertEdge("b", "c", 2);
+  g.InsertEdge("d", "b", 23);
+  g.InsertEdge("d", "d", 5);
+  return g;
+}
+
+}  // namespace
+
+SCENARIO("Freezing an empty graph") {
+  GIVEN("an empty graph") {
+    gdwg::Graph<std::string, int> g;
+
+    WHEN("it is frozen") {
+      auto frozen = g.Freeze();
+
+      THEN("the snapshot has no nodes or edges") {
+        CHECK(frozen.NodeCount() == 0);
+        CHECK(frozen.EdgeCount() == 0);
+        CHECK(frozen.GetNodes().empty());
+        CHECK(frozen.begin() == frozen.end());
+        CHECK(frozen.rbegin() == frozen.rend());
+      }
+    }
+  }
+}
+
+SCENARIO("Querying a frozen graph") {
+  GIVEN("a frozen graph") {
+    auto g = makeGraph();
+    auto frozen = g.Freeze();
+
+    THEN("it answers queries the same way as the graph") {
+      CHECK(frozen.GetNodes() == g.GetNodes());
+      for (const auto& src : g.GetNodes()) {
+        CHECK(frozen.GetConnected(src) == g.GetConnected(src));
+        for (const auto& dst : g.GetNodes()) {
+          CHECK(frozen.IsConnected(src, dst) == g.IsConnected(src, dst));
+          CHECK(frozen.GetWeights(src, dst) == g.GetWeights(src, dst));
+        }
+      }
+      CHECK(frozen.IsNode("e"));
+      CHECK_FALSE(frozen.IsNode("x"));
+    }
+
+    THEN("missing nodes throw the same way as the graph") {
+      CHECK_THROWS_AS(frozen.IsConnected("x", "a"), std::runtime_error);
+      CHECK_THROWS_AS(frozen.GetConnected("x"), std::out_of_range);
+      CHECK_THROWS_AS(frozen.GetWeights("a", "x"), std::out_of_range);
+    }
+
+    WHEN("the original graph is modified") {
+      g.InsertEdge("e", "a", 7);
+
+      THEN("the snapshot is unchanged") { CHECK_FALSE(frozen.IsConnected("e", "a")); }
+    }
+  }
+}
+
+SCENARIO("Iterating over a frozen graph") {
+  GIVEN("a frozen graph") {
+    auto frozen = makeGraph().Freeze();
+    std::vector<std::tuple<std::string, std::string, int>> expected{
+        {"a", "b", 1}, {"a", "b", 10}, {"a", "d", 4}, {"a", "d", 50}, {"b", "b", 2},
+        {"b", "c", 2}, {"c", "b", 3},  {"d", "b", 23}, {"d", "d", 5}};
+
+    THEN("edges come out sorted by source, destination and weight") {
+      std::vector<std::tuple<std::string, std::string, int>> res;
+      for (const auto& [from, to, weight] : frozen) {
+        res.emplace_back(from, to, weight);
+      }
+      CHECK(res == expected);
+    }
+
+    THEN("reverse iteration visits the same edges backwards") {
+      std::vector<std::tuple<std::string, std::string, int>> res;
+      for (auto it = frozen.rbegin(); it != frozen.rend(); ++it) {
+        res.emplace_back(*it);
+      }
+      std::reverse(expected.begin(), expected.end());
+      CHECK(res == expected);
+    }
+  }
+}
+
+SCENARIO("Traversing a frozen graph by id") {
+  GIVEN("a frozen graph") {
+    auto frozen = makeGraph().Freeze();
+
+    THEN("ids follow node order and out-edges are contiguous") {
+      CHECK(frozen.NodeCount() == 5);
+      CHECK(frozen.EdgeCount() == 9);
+      auto a = frozen.GetId("a");
+      CHECK(a == 0);
+      CHECK(frozen.GetValue(frozen.GetId("d")) == "d");
+
+      auto dsts = frozen.GetOutDestinations(a);
+      auto weights = frozen.GetOutWeights(a);
+      REQUIRE(dsts.size() == 4);
+      CHECK(frozen.GetValue(dsts[0]) == "b");
+      CHECK(frozen.GetValue(dsts[3]) == "d");
+      CHECK(std::vector<int>(weights.begin(), weights.end()) == std::vector<int>{1, 10, 4, 50});
+      CHECK(frozen.GetOutDestinations(frozen.GetId("e")).empty());
+      CHECK_THROWS_AS(frozen.GetId("x"), std::out_of_range);
+    }
+  }
+}
@@ -5,22 +5,75 @@
 #ifndef ASSIGNMENTS_DG_GRAPH_H_
 #define ASSIGNMENTS_DG_GRAPH_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
 #include <iostream>
-#include <map>
-#include <memory>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "assignments/dg/copy_on_write.h"
+#include "assignments/dg/edge_list.h"
+#include "assignments/dg/serializer.h"
+#include "assignments/dg/text_writer.h"
+#include "assignments/dg/view.h"
+
 namespace gdwg {
 
+template <typename N, typename E>
+class FrozenGraph;
+
+template <typename N, typename E>
+class MappedGraph;
+
+// Passed to the tuple constructor to promise that the tuples are already
+// sorted by (src, dst, weight) and hold no duplicates, so sorting is skipped
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+// Graphs of integral node values keep an array from value to node id next to
+// the sorted node list, so finding a node is an array lookup instead of a
+// binary search. Values that are negative or far beyond the number of nodes
+// fall back to the search. Specialise this to false for integral values that
+// are spread too thinly to be worth an array.
+template <typename N>
+struct dense_node_ids : std::bool_constant<std::is_integral_v<N> && !std::is_same_v<N, bool>> {};
+
+template <typename N>
+inline constexpr bool dense_node_ids_v = dense_node_ids<N>::value;
+
+// Graphs keep a fingerprint of their nodes and edges if N and E can both be
+// hashed with std::hash, so most unequal graphs are told apart in O(1)
+template <typename T>
+inline constexpr bool hashable_v = std::is_default_constructible_v<std::hash<T>>;
+
 template <typename N, typename E>
 class Graph {
  public:
+  // Handle of a node's slot in the graph's node slab. A handle is only handed
+  // out again once the node it named has been deleted.
+  using NodeId = std::uint32_t;
+
   class Node;
 
-  class const_reverse_iterator {
+  // The outgoing edges of a node. Edges refer to their destination by handle,
+  // so the destination value is stored once, in its node. Trivially copyable
+  // weights are stored in a column of their own, see EdgeList.
+  using OutEdges = EdgeList<NodeId, E>;
+  using Edge = typename OutEdges::Edge;
+
+  class const_iterator {
    public:
     using iterator_category = std::bidirectional_iterator_tag;
     using value_type = std::tuple<N, N, E>;
@@ -32,102 +85,195 @@ class Graph {
 
     reference operator*() const;
 
-    const_reverse_iterator& operator++();
+    const_iterator& operator++();
 
-    const const_reverse_iterator operator++(int);
+    const const_iterator operator++(int);
 
-    const_reverse_iterator& operator--();
+    const_iterator& operator--();
 
-    const const_reverse_iterator operator--(int);
+    const const_iterator operator--(int);
 
-    friend bool operator==(const const_reverse_iterator& lhs, const const_reverse_iterator rhs) {
-      return (lhs.node_iter_ == rhs.node_iter_) && (lhs.edge_iter_ == rhs.edge_iter_) &&
-             (lhs.weight_iter_ == rhs.weight_iter_);
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      // edge_ only means something before the end
+      return lhs.node_iter_ == rhs.node_iter_ &&
+             (lhs.node_iter_ == lhs.node_sentinel_ || lhs.edge_ == rhs.edge_);
     }
 
-    friend bool operator!=(const const_reverse_iterator& lhs, const const_reverse_iterator& rhs) {
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
       return !(lhs == rhs);
     }
 
    private:
     friend class Graph;
-    typename std::vector<std::shared_ptr<Node>>::const_reverse_iterator
-    node_iter_;
-    const typename std::vector<std::shared_ptr<Node>>::const_reverse_iterator
-    node_sentinel_;
-    const typename std::vector<std::shared_ptr<Node>>::const_reverse_iterator
-    reverse_sentinel_;
-    typename std::vector<N>::const_reverse_iterator edge_iter_;
-    typename std::vector<E>::const_reverse_iterator weight_iter_;
-
-    const_reverse_iterator(const decltype(node_iter_)& node_iter,
-                           const decltype(node_sentinel_)& node_sentinel,
-                           const decltype(reverse_sentinel_)& reverse_sentinel_,
-                           const decltype(edge_iter_)& edge_iter,
-                           const decltype(weight_iter_) weight_iter)
-      : node_iter_{node_iter}, node_sentinel_{node_sentinel}, reverse_sentinel_{reverse_sentinel_},
-        edge_iter_{edge_iter}, weight_iter_{weight_iter} {}
+
+    // node_iter_ walks the sorted nodeList_, node_ caches that node (null at
+    // the end) and edge_ is a position in its edges, so no state is copied
+    const Graph* graph_;
+    typename std::pmr::vector<NodeId>::const_iterator node_iter_;
+    typename std::pmr::vector<NodeId>::const_iterator node_sentinel_;
+    typename std::pmr::vector<NodeId>::const_iterator reverse_sentinel_;
+    const Node* node_;
+    std::size_t edge_;
+
+    const_iterator(const Graph* graph,
+                   const decltype(node_iter_)& node_iter,
+                   const decltype(node_sentinel_)& node_sentinel,
+                   const decltype(reverse_sentinel_)& reverse_sentinel_,
+                   std::size_t edge)
+      : graph_{graph}, node_iter_{node_iter}, node_sentinel_{node_sentinel},
+        reverse_sentinel_{reverse_sentinel_},
+        node_{node_iter == node_sentinel ? nullptr : &graph->nodes_[*node_iter]},
+        edge_{edge} {}
   };
 
-  class const_iterator {
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  // Iterates over the distinct destinations of a node's outgoing edges in
+  // place, stepping over parallel edges to the same destination
+  class connected_iterator {
    public:
     using iterator_category = std::bidirectional_iterator_tag;
-    using value_type = std::tuple<N, N, E>;
-    using reference = std::tuple<const N&, const N&, const E&>;
-    using pointer = std::tuple<N*, N*, E*>;
+    using value_type = N;
+    using reference = const N&;
+    using pointer = const N*;
     using difference_type = int;
 
+    reference operator*() const { return graph_->nodes_[edges_->Dst(edge_)].GetValue(); }
+
     pointer operator->() const { return &(operator*()); }
 
-    reference operator*() const;
+    connected_iterator& operator++() {
+      auto dst = edges_->Dst(edge_);
+      do {
+        ++edge_;
+      } while (edge_ != edges_->Size() && edges_->Dst(edge_) == dst);
+      return *this;
+    }
 
-    const_iterator& operator++();
+    connected_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
 
-    const const_iterator operator++(int);
+    connected_iterator& operator--() {
+      --edge_;
+      while (edge_ != 0 && edges_->Dst(edge_ - 1) == edges_->Dst(edge_)) {
+        --edge_;
+      }
+      return *this;
+    }
 
-    const_iterator& operator--();
+    connected_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
 
-    const const_iterator operator--(int);
+    friend bool operator==(const connected_iterator& lhs, const connected_iterator& rhs) {
+      return lhs.edge_ == rhs.edge_;
+    }
+
+    friend bool operator!=(const connected_iterator& lhs, const connected_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class Graph;
+
+    const Graph* graph_;
+    const OutEdges* edges_;
+    std::size_t edge_;
+
+    connected_iterator(const Graph* graph, const OutEdges* edges, std::size_t edge)
+      : graph_{graph}, edges_{edges}, edge_{edge} {}
+  };
+
+  // Iterates over the weights of a run of edges in place. For trivially
+  // copyable weights this is a pointer into the node's weight column.
+  class weight_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = E;
+    using reference = const E&;
+    using pointer = const E*;
+    using difference_type = int;
+
+    reference operator*() const { return OutEdges::WeightOf(cursor_); }
+
+    pointer operator->() const { return &(operator*()); }
 
-    friend bool operator==(const const_iterator& lhs, const const_iterator rhs) {
-      return (lhs.node_iter_ == rhs.node_iter_) && (lhs.edge_iter_ == rhs.edge_iter_) &&
-             (lhs.weight_iter_ == rhs.weight_iter_);
+    weight_iterator& operator++() {
+      ++cursor_;
+      return *this;
     }
 
-    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+    weight_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    weight_iterator& operator--() {
+      --cursor_;
+      return *this;
+    }
+
+    weight_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+
+    friend bool operator==(const weight_iterator& lhs, const weight_iterator& rhs) {
+      return lhs.cursor_ == rhs.cursor_;
+    }
+
+    friend bool operator!=(const weight_iterator& lhs, const weight_iterator& rhs) {
       return !(lhs == rhs);
     }
 
+    weight_iterator() = default;
+
    private:
     friend class Graph;
 
-    typename std::vector<std::shared_ptr<Node>>::const_iterator node_iter_;
-    const typename std::vector<std::shared_ptr<Node>>::const_iterator node_sentinel_;
-    const typename std::vector<std::shared_ptr<Node>>::const_iterator reverse_sentinel_;
-    typename std::vector<N>::const_iterator edge_iter_;
-    typename std::vector<E>::const_iterator weight_iter_;
+    typename OutEdges::weight_cursor cursor_{};
 
-    const_iterator(const decltype(node_iter_)& node_iter,
-                   const decltype(node_sentinel_)& node_sentinel,
-                   const decltype(reverse_sentinel_)& reverse_sentinel_,
-                   const decltype(edge_iter_)& edge_iter,
-                   const decltype(weight_iter_)& weight_iter)
-      : node_iter_{node_iter}, node_sentinel_{node_sentinel}, reverse_sentinel_{reverse_sentinel_},
-        edge_iter_{edge_iter}, weight_iter_{weight_iter} {}
+    explicit weight_iterator(typename OutEdges::weight_cursor cursor) : cursor_{cursor} {}
   };
 
+  using connected_view = View<connected_iterator>;
+  using weights_view = View<weight_iterator>;
+
   // Graph Constructors
+  // Every constructor can be given a memory resource, which all of the
+  // graph's storage is then allocated from. If N is allocator aware (e.g.
+  // std::pmr::string) node values are allocated from it too, as are the
+  // scratch copies of them that the bulk constructors sort. Only the bulk
+  // constructors and batch operations borrow heap space, for arrays of
+  // indices, while they run.
   Graph<N, E>() {}
 
+  explicit Graph<N, E>(std::pmr::memory_resource* resource);
+
   Graph<N, E>(typename std::vector<N>::const_iterator c1,
-              typename std::vector<N>::const_iterator c2);
+              typename std::vector<N>::const_iterator c2,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
   Graph<N, E>(typename std::vector<std::tuple<N, N, E>>::const_iterator,
-              typename std::vector<std::tuple<N, N, E>>::const_iterator);
+              typename std::vector<std::tuple<N, N, E>>::const_iterator,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  Graph<N, E>(sorted_unique_t,
+              typename std::vector<std::tuple<N, N, E>>::const_iterator,
+              typename std::vector<std::tuple<N, N, E>>::const_iterator,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-  Graph<N, E>(std::initializer_list<N>);
+  Graph<N, E>(std::initializer_list<N>,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-  Graph<N, E>(gdwg::Graph<N, E>& g);
+  Graph<N, E>(const gdwg::Graph<N, E>& g);
 
   Graph<N, E>(gdwg::Graph<N, E>&& g);
 
@@ -138,54 +284,40 @@ class Graph {
   Graph<N, E>& operator=(gdwg::Graph<N, E>&& g);
 
   friend bool operator==(const Graph& g1, const Graph& g2) {
-    // check nodelist size
-    if (g1.nodeList_.size() != g2.nodeList_.size()) {
+    // A graph and an unchanged copy share their storage
+    if (g1.nodes_.SharesWith(g2.nodes_) && g1.nodeList_.SharesWith(g2.nodeList_)) {
+      return true;
+    }
+    if (g1.fingerprint_ != g2.fingerprint_) {
       return false;
     }
 
-    // check nodes
-    int max = g1.nodeList_.size();
-    for (int counter = 0; counter < max; counter++) {
-      // check node values
-      if (g1.nodeList_[counter]->GetValue() != g2.nodeList_[counter]->GetValue()) {
-        return false;
-      }
+    const auto& nodeList1 = *g1.nodeList_;
+    const auto& nodeList2 = *g2.nodeList_;
+
+    // check nodelist size
+    if (nodeList1.size() != nodeList2.size()) {
+      return false;
     }
 
-    // check edges
+    // check nodes and their edges in one pass, both edge lists are sorted by
+    // destination then weight
+    int max = nodeList1.size();
     for (int counter = 0; counter < max; counter++) {
-      Node n1 = *g1.nodeList_[counter];
-      Node n2 = *g2.nodeList_[counter];
-
-      std::vector<std::weak_ptr<Node>> children_1 = n1.GetChildren();
-      std::map<N, std::vector<E>> edge_map_1 = n1.GetEdges();
-      std::vector<N> avail_dst_1;
-
-      std::vector<std::weak_ptr<Node>> children_2 = n1.GetChildren();
-      std::map<N, std::vector<E>> edge_map_2 = n1.GetEdges();
-      std::vector<N> avail_dst_2;
-
-      for (auto it = children_1.begin(); it != children_1.end(); ++it) {
-        if (auto childLock = it->lock()) {
-          avail_dst_1.push_back(childLock->GetValue());
-        }
-      }
-
-      for (auto it = children_2.begin(); it != children_2.end(); ++it) {
-        if (auto childLock = it->lock()) {
-          avail_dst_2.push_back(childLock->GetValue());
-        }
+      const Node& n1 = g1.nodes_[nodeList1[counter]];
+      const Node& n2 = g2.nodes_[nodeList2[counter]];
+      if (n1.GetValue() != n2.GetValue()) {
+        return false;
       }
 
-      if (avail_dst_1 != avail_dst_2) {
+      const auto& edges_1 = n1.GetEdges();
+      const auto& edges_2 = n2.GetEdges();
+      if (edges_1.Size() != edges_2.Size()) {
         return false;
       }
-
-      for (auto dst = avail_dst_1.begin(); dst != avail_dst_1.end(); ++dst) {
-        typename std::vector<E> weights_1 = edge_map_1[*dst];
-        typename std::vector<E> weights_2 = edge_map_2[*dst];
-
-        if (weights_1 != weights_2) {
+      for (std::size_t i = 0; i < edges_1.Size(); ++i) {
+        if (g1.nodes_[edges_1.Dst(i)].GetValue() != g2.nodes_[edges_2.Dst(i)].GetValue() ||
+            !(edges_1.Weight(i) == edges_2.Weight(i))) {
           return false;
         }
       }
@@ -196,34 +328,31 @@ class Graph {
   friend bool operator!=(const Graph& g1, const Graph& g2) { return !(g1 == g2); }
 
   friend std::ostream& operator<<(std::ostream& os, const Graph& g) {
+    // The buffered writer gives the same text as a stream formatting as by
+    // default, so only streams set up otherwise are written token by token
+    if (os.flags() == (std::ios_base::skipws | std::ios_base::dec) && os.precision() == 6 &&
+        os.width() == 0 && os.getloc() == std::locale::classic()) {
+      g.WriteText([&os](const char* data, std::size_t size) {
+        return static_cast<bool>(os.write(data, size));
+      });
+      return os;
+    }
+
     const std::string NODE_START = " (";
     const std::string NODE_END = "\n)\n";
     const std::string EDGE_SEPARATOR = " | ";
     const std::string CHILD_START = "\n  ";
 
-    int max = g.nodeList_.size();
-    std::vector<N> output;
+    int max = g.nodeList_->size();
 
     for (int counter = 0; counter < max; counter++) {
-      Node n = *g.nodeList_[counter];
+      const Node& n = g.nodes_[(*g.nodeList_)[counter]];
       os << n.GetValue() << NODE_START;
 
-      std::vector<std::weak_ptr<Node>> children = n.GetChildren();
-      std::map<N, std::vector<E>> edge_map = n.GetEdges();
-      std::vector<N> avail_dst;
-
-      for (auto it = children.begin(); it != children.end(); ++it) {
-        if (auto childLock = it->lock()) {
-          avail_dst.push_back(childLock->GetValue());
-        }
-      }
-
-      for (auto dst = avail_dst.begin(); dst != avail_dst.end(); ++dst) {
-        typename std::vector<E> weights = edge_map[*dst];
-
-        for (auto it = weights.begin(); it != weights.end(); ++it) {
-          os << CHILD_START << *dst << EDGE_SEPARATOR << *it;
-        }
+      const auto& edges = n.GetEdges();
+      for (std::size_t i = 0; i < edges.Size(); ++i) {
+        os << CHILD_START << g.nodes_[edges.Dst(i)].GetValue() << EDGE_SEPARATOR
+           << edges.Weight(i);
       }
 
       os << NODE_END;
@@ -235,6 +364,15 @@ class Graph {
 
   bool InsertNode(const N&);
 
+  std::vector<bool> InsertNodes(typename std::vector<N>::const_iterator first,
+                                typename std::vector<N>::const_iterator last);
+
+  std::vector<bool> InsertEdges(typename std::vector<std::tuple<N, N, E>>::const_iterator first,
+                                typename std::vector<std::tuple<N, N, E>>::const_iterator last);
+
+  std::vector<bool> EraseEdges(typename std::vector<std::tuple<N, N, E>>::const_iterator first,
+                               typename std::vector<std::tuple<N, N, E>>::const_iterator last);
+
   bool DeleteNode(const N&);
 
   bool Replace(const N&, const N&);
@@ -253,12 +391,44 @@ class Graph {
 
   std::vector<E> GetWeights(const N& src, const N& dst);
 
+  connected_view GetConnectedView(const N& src) const;
+
+  weights_view GetWeightsView(const N& src, const N& dst) const;
+
+  // Counts kept up to date by every change, so reading one takes no scan.
+  // Degrees count distinct neighbours, edge counts count parallel edges too.
+  inline std::size_t NodeCount() const { return nodeList_->size(); }
+
+  inline std::size_t EdgeCount() const { return edgeCount_; }
+
+  std::size_t OutDegree(const N& src) const;
+
+  std::size_t InDegree(const N& dst) const;
+
+  std::size_t OutEdgeCount(const N& src) const;
+
+  std::size_t InEdgeCount(const N& dst) const;
+
+  // Queries by weight, answered from an index of each node's edges in order
+  // of weight that is kept until the node's edges next change. The index is
+  // a cache filled in place, so querying a copy doesn't unshare its storage,
+  // but two threads must not query the same node at once.
+  std::vector<std::pair<N, E>> GetEdgesByWeight(const N& src, const E& lo, const E& hi) const;
+
+  std::vector<std::pair<N, E>> GetLightestEdges(const N& src, std::size_t k) const;
+
   const_iterator find(const N&, const N&, const E&);
 
+  bool ContainsEdge(const N& src, const N& dst, const E& w) const;
+
   bool erase(const N& src, const N& dst, const E& w);
 
+  // O(out-degree of the edge's source), see EraseEdgesIf to prune many edges
   const_iterator erase(const_iterator it);
 
+  template <typename Pred>
+  std::size_t EraseEdgesIf(Pred pred);
+
   const_iterator cbegin() const;
 
   const_iterator cend() const;
@@ -275,43 +445,192 @@ class Graph {
 
   inline const_reverse_iterator rend() const { return crend(); }
 
+  // Defined in frozen_graph.tpp
+  FrozenGraph<N, E> Freeze() const;
+
+  bool Dump(std::FILE* out) const;
+
+  bool Dump(int fd) const;
+
+  // Binary snapshots, N and E are stored with Serializer<N> and Serializer<E>
+  void Save(const std::string& path) const;
+
+  static Graph Load(const std::string& path,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  inline std::pmr::memory_resource* GetResource() const {
+    return nodes_.GetResource();
+  }
+
+  // Equal graphs have equal fingerprints. Always 0 unless N and E are
+  // hashable_v.
+  inline std::uint64_t GetFingerprint() const { return fingerprint_; }
+
   class Node {
    private:
+    friend class Graph;
+
     N value_;
-    std::vector<std::weak_ptr<Node>> children_;
-    std::vector<std::weak_ptr<Node>> parents_;
-    std::map<N, std::vector<E>> edges_;
+    // HashNode(value_)
+    std::uint64_t hash_;
+    // Nodes with at least one edge to this node, each listed once and sorted
+    // by id, so one is found or removed by binary search
+    std::pmr::vector<NodeId> parents_;
+    // Out-edges sorted by destination value and then weight, so the edges to
+    // one destination are a single run
+    OutEdges edges_;
+    // Distinct destinations of edges_, i.e. the nodes listing this one in
+    // their parents_
+    std::size_t children_ = 0;
+    // Edges to this node, counting parallel edges
+    std::size_t inEdges_ = 0;
+
+    // Copies value with the resource's allocator when N can use one
+    static N MakeValue(const N& value, std::pmr::memory_resource* resource) {
+      if constexpr (std::uses_allocator_v<N, std::pmr::polymorphic_allocator<std::byte>>) {
+        return N(value, std::pmr::polymorphic_allocator<std::byte>{resource});
+      } else {
+        return value;
+      }
+    }
 
    public:
     Node();
 
-    explicit Node(N value) : value_(value) {}
+    Node(const N& value, std::pmr::memory_resource* resource)
+      : value_(MakeValue(value, resource)), hash_(HashNode(value)), parents_(resource),
+        edges_(resource) {}
 
-    inline std::vector<std::weak_ptr<Node>> GetChildren() { return children_; }
+    Node(const Node& other, std::pmr::memory_resource* resource)
+      : value_(MakeValue(other.value_, resource)), hash_(other.hash_),
+        parents_(other.parents_, resource), edges_(other.edges_, resource),
+        children_(other.children_), inEdges_(other.inEdges_) {}
 
-    inline std::vector<std::weak_ptr<Node>> GetParents() { return parents_; }
+    inline const std::pmr::vector<NodeId>& GetParents() const { return parents_; }
+
+    inline const OutEdges& GetEdges() const { return edges_; }
+
+    inline const N& GetValue() const { return value_; }
+  };
+
+ private:
+  friend class FrozenGraph<N, E>;
+  friend class MappedGraph<N, E>;
 
-    inline std::map<N, std::vector<E>> GetEdges() { return edges_; }
+  static constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
 
-    inline N GetValue() { return value_; }
+  // Returns NO_NODE if val is not a node
+  NodeId FindNode(const N& val) const;
 
-    inline void ChangeValue(N val) { value_ = val; }
+  NodeId AllocateNode(const N& val);
 
-    void UpdateEdges(std::vector<E> weights, N newNode, N oldNode);
+  void FreeNode(NodeId id);
 
-    bool AddEdge(const N&, const E&);
+  // Keep denseIndex_ in step with the node values, no-ops unless
+  // dense_node_ids_v<N>
+  bool InDenseIndex(const N& val) const;
 
-    void AddChild(std::weak_ptr<Node>);
+  void IndexNode(NodeId id);
 
-    void RemoveChild(const N&);
+  void UnindexNode(NodeId id);
 
-    void AddParent(std::weak_ptr<Node>);
+  typename std::pmr::vector<NodeId>::const_iterator LowerBoundNode(const N& val) const;
 
-    void RemoveParent(const N&);
+  template <typename Values>
+  void LoadNodes(const Values& values);
+
+  template <typename Sink>
+  bool WriteText(Sink sink) const;
+
+  void ShareFrom(const Graph& g);
+
+  void CopyFrom(const Graph& g);
+
+  template <typename TupleIt>
+  void LoadEdges(TupleIt first, TupleIt last);
+
+  // Start of a file written by Save
+  struct SaveHeader {
+    char magic[4];
+    std::uint32_t version;
+    // Reads back differently on a machine of the other byte order
+    std::uint32_t byteOrder;
+    // sizeof(N) and sizeof(E) if they are stored bitwise, 0 otherwise
+    std::uint32_t nodeSize;
+    std::uint32_t weightSize;
+    std::uint32_t reserved;
+    std::uint64_t nodes;
+    std::uint64_t edges;
   };
 
- private:
-  std::vector<std::shared_ptr<Node>> nodeList_;
+  static SaveHeader MakeSaveHeader(std::uint64_t nodes, std::uint64_t edges);
+
+  // Each part of a saved file starts at a multiple of this, so a mapped file
+  // can be used in place
+  static constexpr std::size_t SAVE_ALIGNMENT = 64;
+
+  // Stored as their bytes, so weights are saved and loaded a column at a time
+  static constexpr bool BITWISE_NODES = Serializer<N>::BITWISE && std::is_trivially_copyable_v<N>;
+
+  static constexpr bool BITWISE_WEIGHTS = Serializer<E>::BITWISE && std::is_trivially_copyable_v<E>;
+
+  // Edge storage, every edge change keeps each node's parents_ in step
+
+  // Edges are addressed by their position in the source's edges_
+  std::pair<std::size_t, std::size_t> EdgeRange(NodeId src, const N& dst) const;
+
+  std::size_t FindEdge(NodeId src, const N& dst, const E& w) const;
+
+  bool AddEdge(NodeId src, NodeId dst, const E& w);
+
+  void RemoveEdges(NodeId src, NodeId dst);
+
+  void AddParent(NodeId node, NodeId parent);
+
+  void RemoveParent(NodeId node, NodeId parent);
+
+  // Keep edgeCount_ and dst's inEdges_ in step with count edges to dst
+  void AddInEdges(NodeId dst, std::size_t count);
+
+  void RemoveInEdges(NodeId dst, std::size_t count);
+
+  void UpdateEdges(NodeId src, const N& newNode, const N& oldNode);
+
+  bool RedirectEdges(NodeId src, NodeId from, NodeId to);
+
+  const OutEdges& WeightOrdered(NodeId src) const;
+
+  // Fingerprint terms, fingerprint_ is the sum of the terms of every node
+  // and edge so it can be kept up to date as they come and go
+  static std::uint64_t HashNode(const N& val);
+
+  std::uint64_t HashEdge(NodeId src, NodeId dst, const E& w) const;
+
+  static std::uint64_t HashEdge(std::uint64_t srcHash, std::uint64_t dstHash, const E& w);
+
+  std::uint64_t HashIncidentEdges(NodeId id) const;
+
+  // Batches, both take edges sorted by destination then weight
+  void MergeEdges(NodeId src, const std::pmr::vector<Edge>& added);
+
+  void EraseEdges(NodeId src, const std::vector<Edge>& removed);
+
+  // Nodes live in one slab and refer to each other by NodeId, so no node is
+  // allocated on its own. Slots of deleted nodes are recycled via freeIds_.
+  // All four containers share the graph's memory resource. Copies of a graph
+  // share them too, and a write only copies the part it changes, so writes
+  // go through Mutable().
+  PagedSlab<Node> nodes_{std::pmr::get_default_resource()};
+  CopyOnWrite<std::pmr::vector<NodeId>> freeIds_{std::pmr::get_default_resource()};
+  // nodeList_ keeps the live ids sorted by value, for iteration and for
+  // lookups by binary search. The slab is the only place a value is stored,
+  // so each distinct value is held once and everything else uses its id.
+  CopyOnWrite<std::pmr::vector<NodeId>> nodeList_{std::pmr::get_default_resource()};
+  // denseIndex_[val] is the id of node val, or NO_NODE, for every val below
+  // its size. Only used if dense_node_ids_v<N>.
+  CopyOnWrite<std::pmr::vector<NodeId>> denseIndex_{std::pmr::get_default_resource()};
+  std::uint64_t fingerprint_ = 0;
+  std::size_t edgeCount_ = 0;
 };
 
 }  // namespace gdwg
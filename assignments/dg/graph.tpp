@@ -5,7 +5,14 @@
 
 #include "assignments/dg/graph.h"
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <utility>
 
@@ -44,1040 +51,2166 @@ std::vector<X> mergeSorted(std::vector<X> v1, std::vector<X> v2) {
   return result;
 }
 
-// Node Functions
+/**
+ * Sorts v and removes any repeated values
+ *
+ * @param v - vector to be sorted
+ */
+template <typename Vector>
+void sortUnique(Vector& v) {
+  std::sort(v.begin(), v.end());
+  v.erase(std::unique(v.begin(), v.end()), v.end());
+}
 
 /**
- * Remove child of node
+ * Binary search for the first position in [first, last) at which pred is
+ * false, where pred holds for some prefix of the positions
  *
- * @param n - node to be removed
+ * @param first - first position
+ * @param last - one past the last position
+ * @param pred - pred(i) for a position i
  */
-template <typename N, typename E>
-void gdwg::Graph<N, E>::Node::RemoveChild(const N& n) {
-  auto children = GetChildren();
-  for (auto it = children.begin(); it != children.end(); ++it) {
-    if (auto childShared = it->lock()) {
-      if (childShared->GetValue() == n) {
-        children.erase(it);
-        break;
-      }
+template <typename Pred>
+std::size_t partitionPoint(std::size_t first, std::size_t last, Pred pred) {
+  while (first < last) {
+    auto mid = first + (last - first) / 2;
+    if (pred(mid)) {
+      first = mid + 1;
+    } else {
+      last = mid;
     }
   }
-  return;
+  return first;
 }
 
 /**
- * Remove the parent of the node
+ * Scrambles the bits of x, so that sums of scrambled hashes rarely collide
  *
- * @param n - node to be removed
+ * @param x - hash to be scrambled
  */
-template <typename N, typename E>
-void gdwg::Graph<N, E>::Node::RemoveParent(const N& n) {
-  auto parents = GetParents();
-  for (auto it = parents.begin(); it != parents.end(); ++it) {
-    if (auto parentShared = it->lock()) {
-      if (parentShared->GetValue() == n) {
-        parents.erase(it);
-        break;
-      }
-    }
-  }
-  return;
+inline std::uint64_t mixHash(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
 }
 
+// Node Storage
+
 /**
- * Add node as child of another node
+ * Looks up the id of the node holding val by binary search of nodeList_ in
+ * O(log V), or in O(1) if val is covered by the dense index
  *
- * @param dst - destination node to be added
+ * @param val - value of the node
+ * @return the id, or NO_NODE if val is not in the graph
  */
 template <typename N, typename E>
-void gdwg::Graph<N, E>::Node::AddChild(std::weak_ptr<Node> dst) {
-  bool found = false;
-  auto dstLock = dst.lock();
-  auto it = children_.begin();
-  while (it != children_.end()) {
-    if (auto child = it->lock()) {
-      if (dstLock->GetValue() == child->GetValue()) {
-        found = true;
-        break;
-      } else if (dstLock->GetValue() > child->GetValue()) {
-        it++;
-      } else {
-        break;
-      }
+typename gdwg::Graph<N, E>::NodeId gdwg::Graph<N, E>::FindNode(const N& val) const {
+  if constexpr (dense_node_ids_v<N>) {
+    if (InDenseIndex(val)) {
+      return (*denseIndex_)[static_cast<std::size_t>(val)];
     }
   }
-
-  if (!found) {
-    children_.insert(it, dst);
+  auto it = LowerBoundNode(val);
+  if (it == nodeList_->end() || val < nodes_[*it].GetValue()) {
+    return NO_NODE;
   }
-  return;
+  return *it;
 }
 
 /**
- * Add destination and edge to the node's edges_ list
+ * Places a new node holding val in the slab, reusing the slot of a deleted
+ * node if there is one. The node is not added to nodeList_.
  *
- * @param dst - destination node
- * @param w - weight of edge
+ * @param val - value of the node
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::Node::AddEdge(const N& dst, const E& w) {
-  auto it = edges_[dst].begin();
-  while (it != edges_[dst].end()) {
-    if (w > *it) {
-      it++;
-    } else if (w == *it) {
-      return false;
-    } else {
-      break;
-    }
+typename gdwg::Graph<N, E>::NodeId gdwg::Graph<N, E>::AllocateNode(const N& val) {
+  NodeId id;
+  if (freeIds_->empty()) {
+    id = nodes_.Size();
+    nodes_.EmplaceBack(val, GetResource());
+  } else {
+    id = freeIds_->back();
+    freeIds_.Mutable().pop_back();
+    nodes_.Mutable(id) = Node(val, GetResource());
   }
-  edges_[dst].insert(it, w);
-  std::sort(edges_[dst].begin(), edges_[dst].end());
-  return true;
+  IndexNode(id);
+  fingerprint_ += nodes_[id].hash_;
+  return id;
 }
 
 /**
- * Add node as a parent of another
+ * Releases the slot of a node that has been unlinked from the graph, so it
+ * can be reused by the next AllocateNode
  *
- * @param src - node to be added
+ * @param id - node to be freed
  */
 template <typename N, typename E>
-void gdwg::Graph<N, E>::Node::AddParent(std::weak_ptr<Node> src) {
-  auto nextParent = parents_.begin();
-  bool found = false;
-  auto srcLock = src.lock();
-  for (auto it = parents_.begin(); it != parents_.end(); it++) {
-    if (auto parent = it->lock()) {
-      if (srcLock->GetValue() < parent->GetValue()) {
-        nextParent = it;
-      } else if (srcLock->GetValue() == parent->GetValue()) {
-        found = true;
-        break;
-      }
-    }
-  }
-
-  if (!found) {
-    parents_.insert(nextParent, std::weak_ptr<Node>(src));
-  }
-  return;
+void gdwg::Graph<N, E>::FreeNode(NodeId id) {
+  UnindexNode(id);
+  fingerprint_ -= nodes_[id].hash_;
+  // Swapping with an empty vector could mix resources, so shrink in place
+  auto& node = nodes_.Mutable(id);
+  node.edges_.Release();
+  node.parents_.clear();
+  node.parents_.shrink_to_fit();
+  freeIds_.Mutable().push_back(id);
 }
 
 /**
- * Replaces the destination node in teh edges_ map
+ * Binary search for the position of val in the sorted nodeList_
  *
- * @param weights - new vector of weights from this node to newNode
- * @param newNode - new dst
- * @param oldNode - old dst
+ * @param val - value being searched for
  */
 template <typename N, typename E>
-void gdwg::Graph<N, E>::Node::UpdateEdges(std::vector<E> weights, N newNode, N oldNode) {
-  this->edges_[newNode] = weights;
-  auto old_key_it = this->edges_.find(oldNode);
-  this->edges_.erase(old_key_it);
+typename std::pmr::vector<typename gdwg::Graph<N, E>::NodeId>::const_iterator
+gdwg::Graph<N, E>::LowerBoundNode(const N& val) const {
+  // Nodes are often added in increasing order, so try the end first
+  if (nodeList_->empty() || nodes_[nodeList_->back()].GetValue() < val) {
+    return nodeList_->end();
+  }
+  return std::lower_bound(nodeList_->begin(), nodeList_->end(), val,
+                          [this](NodeId id, const N& v) { return nodes_[id].GetValue() < v; });
 }
 
-// Graph Functions
 /**
- * Constructor
- * Takes the start and end of a const_iterator to a std:vector<N> and adds those
- * nodes to the graph.
- * @param c1 - beginning of vector of node values
- * @param c2 - end of vector of node values
+ * Returns true if val falls inside the dense index, i.e. the index holds its
+ * id or NO_NODE if it isn't a node
+ *
+ * @param val - value of potential node
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(typename std::vector<N>::const_iterator c1,
-                         typename std::vector<N>::const_iterator c2) {
-  for (auto& it = c1; it != c2; it++) {
-    // Check for duplicates in initaliser vector
-    bool alreadyInList = false;
-    for (const auto& item : nodeList_) {
-      if (item->GetValue() == *it) {
-        alreadyInList = true;
-        break;
-      }
-    }
-    if (!alreadyInList) {
-      auto listItem = nodeList_.begin();
-      while (listItem != nodeList_.end()) {
-        if (*it > (*listItem)->GetValue()) {
-          listItem++;
-        } else {
-          break;
-        }
+bool gdwg::Graph<N, E>::InDenseIndex(const N& val) const {
+  if constexpr (dense_node_ids_v<N>) {
+    if constexpr (std::is_signed_v<N>) {
+      if (val < 0) {
+        return false;
       }
-      nodeList_.insert(listItem, std::shared_ptr<Node>(new Node(*it)));
     }
-  }
-}
-
-template <typename N, typename E>
-bool sortTuple(const std::tuple<N, N, E>& a, const std::tuple<N, N, E>& b) {
-  if (std::get<1>(a) != std::get<1>(b)) {
-    return (std::get<1>(a) == std::get<1>(b));
+    return static_cast<std::size_t>(val) < denseIndex_->size();
   } else {
-    if (std::get<2>(a) != std::get<2>(b)) {
-      return (std::get<2>(a) < std::get<2>(b));
-    } else {
-      return (std::get<3>(a) < std::get<3>(b));
-    }
+    return false;
   }
 }
 
 /**
- * Constructor
- * Iterators over tuples of (source node, destination node, edge weight) and
- * adds them to the graph.
+ * Records node id in the dense index. The index grows to take in the value
+ * if it is no more than about twice the number of nodes, so it stays within
+ * a small factor of nodeList_ however the values are spread. Growing doubles
+ * the index and picks up any nodes that were outside it.
  *
- * @param c1 - beginning of vector of tuples
- * @param c2 - end of over vector of tuples
+ * @param id - node whose value has just been set
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator c1,
-                         typename std::vector<std::tuple<N, N, E>>::const_iterator c2) {
-  sort(c1, c2, sortTuple);
-
-  for (auto& it = c1; it != c2; it++) {
-    // Check for duplicates in initaliser vector
-    bool alreadyInList = false;
-    for (auto i = 0; i < 2; i++) {
-      for (const auto& node : nodeList_) {
-        if (node->GetValue() == *it[i]) {
-          alreadyInList = true;
-          break;
+void gdwg::Graph<N, E>::IndexNode(NodeId id) {
+  if constexpr (dense_node_ids_v<N>) {
+    const auto& val = nodes_[id].GetValue();
+    if (!InDenseIndex(val)) {
+      if constexpr (std::is_signed_v<N>) {
+        if (val < 0) {
+          return;
         }
       }
-      if (!alreadyInList) {
-        nodeList_.push(std::shared_ptr<Node>(new Node(*it)));
+      auto limit = 2 * (nodeList_->size() + 1) + 64;
+      if (static_cast<std::size_t>(val) >= limit) {
+        return;
+      }
+      auto oldSize = denseIndex_->size();
+      auto& index = denseIndex_.Mutable();
+      index.resize(std::max<std::size_t>(static_cast<std::size_t>(val) + 1, 2 * oldSize), NO_NODE);
+      for (auto node : *nodeList_) {
+        const auto& other = nodes_[node].GetValue();
+        if (InDenseIndex(other) && static_cast<std::size_t>(other) >= oldSize) {
+          index[static_cast<std::size_t>(other)] = node;
+        }
       }
     }
-    InsertEdge(it[0], it[1], it[2]);
+    denseIndex_.Mutable()[static_cast<std::size_t>(val)] = id;
   }
 }
 
+/**
+ * Removes node id from the dense index
+ *
+ * @param id - node whose value is about to go
+ */
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(std::initializer_list<N> args) {
-  for (auto it = args.begin(); it != args.end(); it++) {
-    // Check for duplicates in initaliser vector
-    bool alreadyInList = false;
-    for (const auto& item : nodeList_) {
-      if (item->GetValue() == *it) {
-        alreadyInList = true;
-        break;
-      }
-    }
-    if (!alreadyInList) {
-      auto listItem = nodeList_.begin();
-      while (listItem != nodeList_.end()) {
-        if (*it > (*listItem)->GetValue()) {
-          listItem++;
-        } else {
-          break;
-        }
-      }
-      nodeList_.insert(listItem, std::shared_ptr<Node>(new Node(*it)));
+void gdwg::Graph<N, E>::UnindexNode(NodeId id) {
+  if constexpr (dense_node_ids_v<N>) {
+    if (InDenseIndex(nodes_[id].GetValue())) {
+      denseIndex_.Mutable()[static_cast<std::size_t>(nodes_[id].GetValue())] = NO_NODE;
     }
   }
 }
 
+// Fingerprint
+
 /**
- * Copy Constructor
+ * Returns the fingerprint term of a node with value val
  *
- * @param g - graph being copied
+ * @param val - value of the node
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>& g) {
-  // Initialise copied graph with nodeList_
-  for (auto it = g.GetNodes().begin(); it != g.GetNodes().end(); it++) {
-    this->InsertNode(*it);
+std::uint64_t gdwg::Graph<N, E>::HashNode(const N& val) {
+  if constexpr (hashable_v<N> && hashable_v<E>) {
+    return mixHash(std::hash<N>{}(val));
+  } else {
+    return 0;
   }
-  // Copy every edge into graph
-  auto it = g.begin();
-  std::tuple<N, N, E> temp = *it;
-
-  //    for (auto it = g.begin(); it != g.end(); ++it) {
-  //        this->InsertEdge(*it);
-  //        std::tuple<N,N,E> temp = *it;
-  //    }
 }
 
 /**
- * Move Constructor
+ * Returns the fingerprint term of the edge src → dst with weight w. It only
+ * depends on the values of the nodes, not their ids.
  *
- * @param g - graph being moved
+ * @param src - source node
+ * @param dst - destination node
+ * @param w - weight of edge
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& g) {
-  this->nodeList_ = std::move(g.nodeList_);
+std::uint64_t gdwg::Graph<N, E>::HashEdge(NodeId src, NodeId dst, const E& w) const {
+  return HashEdge(nodes_[src].hash_, nodes_[dst].hash_, w);
 }
 
 /**
- * Destructor
+ * Returns the fingerprint term of an edge from the node hashes of its ends
+ *
+ * @param srcHash - HashNode of the source's value
+ * @param dstHash - HashNode of the destination's value
+ * @param w - weight of edge
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>::~Graph() {
-  for (auto node : nodeList_) {
-    delete node.get();
+std::uint64_t gdwg::Graph<N, E>::HashEdge(std::uint64_t srcHash, std::uint64_t dstHash,
+                                          const E& w) {
+  if constexpr (hashable_v<N> && hashable_v<E>) {
+    return mixHash(srcHash ^ mixHash(dstHash + std::hash<E>{}(w)));
+  } else {
+    return 0;
   }
-  nodeList_.clear();
 }
 
 /**
- * A copy assignment operator overload
+ * Returns the sum of the fingerprint terms of every edge to or from a node,
+ * counting self edges once
  *
- * @param g - graph being copy assigned
+ * @param id - node
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& g) {
-  if (&g == *this) {
-    return *this;
-  }
-  // Initialise copied graph with nodeList_
-  for (auto& it = g->GetNodes().begin(); it != g->GetNodes().end(); it++) {
-    this->InsertNode(*it);
-  }
-  // Copy every edge into graph
-  for (auto& it = g.begin(); it != g.end(); g++) {
-    this->InsertEdge(*it);
+std::uint64_t gdwg::Graph<N, E>::HashIncidentEdges(NodeId id) const {
+  std::uint64_t sum = 0;
+  if constexpr (hashable_v<N> && hashable_v<E>) {
+    const auto& node = nodes_[id];
+    const auto& edges = node.GetEdges();
+    for (std::size_t i = 0; i < edges.Size(); ++i) {
+      sum += HashEdge(id, edges.Dst(i), edges.Weight(i));
+    }
+    for (auto parent : node.GetParents()) {
+      if (parent != id) {
+        auto range = EdgeRange(parent, node.GetValue());
+        for (auto i = range.first; i < range.second; ++i) {
+          sum += HashEdge(parent, id, nodes_[parent].GetEdges().Weight(i));
+        }
+      }
+    }
   }
-  return *this;
+  return sum;
 }
 
+// Edge Storage
+
 /**
- * A move assignment operator overload
+ * Returns the positions [first, last) of the run of src's edges going to
+ * dst, found by binary search
  *
- * @param g - graph being move assigned
+ * @param src - source node
+ * @param dst - destination node
  */
 template <typename N, typename E>
-gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(gdwg::Graph<N, E>&& g) {
-  if (&g == *this) {
-    return *this;
-  }
-  this->nodeList_ = std::move(g.nodeList_);
-  return *this;
+std::pair<std::size_t, std::size_t> gdwg::Graph<N, E>::EdgeRange(NodeId src, const N& dst) const {
+  const auto& edges = nodes_[src].edges_;
+  auto first = partitionPoint(0, edges.Size(), [this, &edges, &dst](std::size_t i) {
+    return nodes_[edges.Dst(i)].GetValue() < dst;
+  });
+  auto last = partitionPoint(first, edges.Size(), [this, &edges, &dst](std::size_t i) {
+    return !(dst < nodes_[edges.Dst(i)].GetValue());
+  });
+  return {first, last};
 }
 
 /**
- * Adds a new node with value val to the graph. This function returns true if
- * the node is added to the graph and false if there is already a node
- * containing val in the graph (with the graph unchanged).
+ * Binary search for the edge src → dst with weight w
  *
- * @param n - node to be inserted
+ * @param src - source node
+ * @param dst - destination node
+ * @param w - weight of edge
+ * @return the position of the edge, or the number of src's edges if it
+ * doesn't exist
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::InsertNode(const N& n) {
-  // Insert node at beginning by default
-  auto it = nodeList_.begin();
-
-  while (it != nodeList_.end()) {
-    if (n == (*it)->GetValue()) {
-      return false;
-    }
-
-    // Insert node before every value it is less than
-    if (n > (*it)->GetValue()) {
-      ++it;
-    } else {
-      nodeList_.insert(it, std::shared_ptr<Node>(new Node(n)));
-      return true;
-    }
+std::size_t gdwg::Graph<N, E>::FindEdge(NodeId src, const N& dst, const E& w) const {
+  const auto& edges = nodes_[src].edges_;
+  auto range = EdgeRange(src, dst);
+  auto pos = partitionPoint(range.first, range.second,
+                            [&edges, &w](std::size_t i) { return edges.Weight(i) < w; });
+  if (pos == range.second || !(edges.Weight(pos) == w)) {
+    return edges.Size();
   }
-
-  nodeList_.push_back(std::shared_ptr<Node>(new Node(n)));
-  return true;
+  return pos;
 }
 
 /**
- * Adds a new edge src → dst with weight w. This function returns true if the
- * edge is added and false if the edge src → dst with weight w already exists
- * in the graph. Note: Nodes are allowed to be connected to themselves.
+ * Add the edge src → dst with weight w to src's edges, keeping them sorted.
+ * src becomes a parent of dst if this is its first edge to dst.
  *
  * @param src - source node
  * @param dst - destination node
  * @param w - weight of edge
+ * @return false if the edge already exists
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
-  bool srcPresent = false;
-  bool dstPresent = false;
-
-  // Find pointers to src and dst nodes
-  std::shared_ptr<Node> srcNode;
-  std::shared_ptr<Node> dstNode;
-  for (const auto& node : nodeList_) {
-    if (node->GetValue() == src) {
-      srcNode = node;
-      srcPresent = true;
-    }
-    if (node->GetValue() == dst) {
-      dstNode = node;
-      dstPresent = true;
-    }
-  }
-
-  // Exception Handling
-  if (srcPresent == false || dstPresent == false) {
-    throw std::runtime_error("Cannot call Graph::InsertEdge when either "
-                             "src or dst node does not exist");
+bool gdwg::Graph<N, E>::AddEdge(NodeId src, NodeId dst, const E& w) {
+  const auto& edges = nodes_[src].edges_;
+  auto range = EdgeRange(src, nodes_[dst].GetValue());
+  auto pos = partitionPoint(range.first, range.second,
+                            [&edges, &w](std::size_t i) { return edges.Weight(i) < w; });
+  if (pos != range.second && edges.Weight(pos) == w) {
+    return false;
   }
-
-  // Check if an edge exists
-  if (srcNode->AddEdge(dst, w)) {
-    srcNode->AddChild(dstNode);
-    dstNode->AddParent(srcNode);
-    return true;
+  if (range.first == range.second) {
+    AddParent(dst, src);
   }
-  return false;
+  nodes_.Mutable(src).edges_.Insert(pos, dst, w);
+  AddInEdges(dst, 1);
+  fingerprint_ += HashEdge(src, dst, w);
+  return true;
 }
 
 /**
- * Deletes a given node and all its associated incoming and outgoing edges.
- * This function does nothing (returns false) if the node that is to be deleted
- * does not exist in the graph.
+ * Remove every edge src → dst, and src from dst's parents
  *
- * @param n - node to be deleted
+ * @param src - source node
+ * @param dst - destination node
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::DeleteNode(const N& n) {
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); ++it) {
-    if ((*it)->GetValue() == n) {
-      nodeList_.erase(it);
-      return true;
+void gdwg::Graph<N, E>::RemoveEdges(NodeId src, NodeId dst) {
+  auto range = EdgeRange(src, nodes_[dst].GetValue());
+  if (range.first != range.second) {
+    for (auto i = range.first; i < range.second; ++i) {
+      fingerprint_ -= HashEdge(src, dst, nodes_[src].GetEdges().Weight(i));
     }
+    nodes_.Mutable(src).edges_.Erase(range.first, range.second);
+    RemoveInEdges(dst, range.second - range.first);
+    RemoveParent(dst, src);
   }
-  return false;
 }
 
 /**
- * Replaces the original data, oldData, stored at this particular node by the
- * replacement data, newData. If an exception is not thrown, this function
- * returns false if a node that contains value newData already exists in the
- * graph (with the graph unchanged) and true otherwise.
+ * Add parent to the parents of node, keeping them sorted by id, and count
+ * node as one more of parent's children
  *
- * @param oldData - to be replaced
- * @param newData - replaced with
+ * @param node - node gaining a parent
+ * @param parent - node to be added, not yet a parent of node
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::Replace(const N& oldData, const N& newData) {
-  // Find old and new node
-  auto old = nodeList_.end();
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if ((*it)->GetValue() == newData) {
-      return false;
-    }
-    if ((*it)->GetValue() == oldData) {
-      old = it;
-    }
-  }
-
-  // If old value was found
-  if (old != nodeList_.end()) {
-    // Replace value
-    (*old)->ChangeValue(newData);
-
-    // edit edges map in parents of oldNode
-    auto parents = (*old)->GetParents();
-    for (auto it = parents.begin(); it != parents.end(); ++it) {
-      if (auto sharedParent = it->lock()) {
-        auto edges = sharedParent->GetEdges();
-        std::vector<E> newWeightVector;
-
-        for (const auto& edge : edges[oldData]) {
-          newWeightVector.push_back(edge);
-        }
-
-        sharedParent->UpdateEdges(newWeightVector, newData, oldData);
-      }
-    }
-    return true;
-  }
-  throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
+void gdwg::Graph<N, E>::AddParent(NodeId node, NodeId parent) {
+  auto& parents = nodes_.Mutable(node).parents_;
+  parents.insert(std::lower_bound(parents.begin(), parents.end(), parent), parent);
+  ++nodes_.Mutable(parent).children_;
 }
 
 /**
- * All instances of node oldData in the graph are replaced with instances of
- * newData. After completing, every incoming and outgoing edge of oldData
- * becomes an incoming/outgoing edge of newData, except that duplicate edges
- * must be removed.
+ * Remove parent from the parents of node. Since they are sorted by id this is
+ * a binary search, so a node with many parents loses one without a scan.
  *
- * @param oldData - to be replaced
- * @param newData - replaced with
+ * @param node - node losing a parent
+ * @param parent - node to be removed
  */
 template <typename N, typename E>
-void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
-  if (oldData == newData) {
-    return;
-  }
-  // Find shared_ptr to nodes within nodeList_
-  auto oldPtr = nodeList_.end();
-  auto newPtr = nodeList_.end();
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if ((*it)->GetValue() == newData) {
-      newPtr = it;
-    }
-    if ((*it)->GetValue() == oldData) {
-      oldPtr = it;
-    }
-  }
-
-  // Exception Handling
-  if (oldPtr == nodeList_.end() || newPtr == nodeList_.end()) {
-    throw std::runtime_error("Cannot call Graph::MergeReplace on old or new data if they "
-                             "don't exist in the graph");
-  }
-  auto oldNode = *oldPtr;
-  auto newNode = *newPtr;
-
-  // Handle incoming edges of oldNode
-  auto parentList = oldNode->GetParents();
-  for (auto it = parentList.begin(); it != parentList.end(); it++) {
-    if (const auto parentShared = it->lock()) {
-      // If it is a self edge
-      if (parentShared->GetValue() == oldData) {
-        // Add self child
-        newNode->AddChild(std::weak_ptr<Node>(newNode));
-        // Include all self edges
-        auto pEdge = parentShared->GetEdges();
-        for (const auto& w : pEdge[oldData]) {
-          this->InsertEdge(newData, newData, w);
-        }
-
-      } else {
-        // Remove child
-        parentShared->RemoveChild(oldData);
-        // Insert edges from parents to newNode
-        auto pEdge = parentShared->GetEdges();
-        for (const auto& w : pEdge[oldData]) {
-          this->InsertEdge(parentShared->GetValue(), newData, w);
-        }
-      }
-    }
-  }
-
-  // Handle outgoing edges of oldNode
-  auto childList = oldNode->GetChildren();
-  auto oldEdges = oldNode->GetEdges();
-  // For all children
-  for (auto it = childList.begin(); it != childList.end(); it++) {
-    // If still valid
-    if (const auto childShared = it->lock()) {
-      // Find destination and all its edge weights
-      auto dst = childShared->GetValue();
-      auto weights = oldEdges[dst];
-      // Insert all edges to lead from newNode
-      for (auto w = weights.begin(); w != weights.end(); w++) {
-        this->InsertEdge(newData, dst, *w);
-      }
-    }
-  }
+void gdwg::Graph<N, E>::RemoveParent(NodeId node, NodeId parent) {
+  auto& parents = nodes_.Mutable(node).parents_;
+  parents.erase(std::lower_bound(parents.begin(), parents.end(), parent));
+  --nodes_.Mutable(parent).children_;
+}
 
-  nodeList_.erase(oldPtr);
+/**
+ * Count count more edges to dst, in dst and in the graph
+ *
+ * @param dst - destination of the edges
+ * @param count - number of edges added
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::AddInEdges(NodeId dst, std::size_t count) {
+  nodes_.Mutable(dst).inEdges_ += count;
+  edgeCount_ += count;
 }
 
 /**
- * Remove all nodes and edges from the graph. New nodes or edges can be added
- * to the graph afterwards.
+ * Count count fewer edges to dst, in dst and in the graph
+ *
+ * @param dst - destination of the edges
+ * @param count - number of edges removed
  */
 template <typename N, typename E>
-void gdwg::Graph<N, E>::Clear() {
-  nodeList_.clear();
+void gdwg::Graph<N, E>::RemoveInEdges(NodeId dst, std::size_t count) {
+  nodes_.Mutable(dst).inEdges_ -= count;
+  edgeCount_ -= count;
 }
 
 /**
- * Returns true if a node with value val exists in the graph and false
- * otherwise.
- * @param val - value of potential node
+ * Returns src's edges with their weight order sorted. It is only sorted if
+ * the edges changed since it was last used, and then in place: the order
+ * follows from the edges, so it is the same for every graph sharing src's
+ * page, and the page isn't copied. WeightOrder lets copies sharing the page
+ * sort it from different threads.
+ *
+ * @param src - source node
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::IsNode(const N& val) {
-  for (const auto& node : nodeList_) {
-    if (node->GetValue() == val) {
-      return true;
-    }
-  }
-  return false;
+const typename gdwg::Graph<N, E>::OutEdges& gdwg::Graph<N, E>::WeightOrdered(NodeId src) const {
+  const auto& edges = nodes_[src].edges_;
+  edges.SortByWeight();
+  return edges;
 }
 
 /**
- * Returns true if the edge src → dst exists in the graph and false otherwise.
+ * Points src's edges to from at to instead, merging them into src's edges to
+ * to in one pass and dropping those src already has. The parents of from and
+ * to are left to the caller, so a node with many parents can have them
+ * updated at once, but src's count of children is kept here.
  *
  * @param src - source node
- * @param dst - destination node
- * @return
+ * @param from - destination losing its edges from src
+ * @param to - destination gaining them
+ * @return true if src had edges to from but none to to, i.e. src becomes a
+ * parent of to
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) {
-  auto srcNode = nodeList_.end();
-  bool dstFound = false;
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if ((*it)->GetValue() == src) {
-      srcNode = it;
+bool gdwg::Graph<N, E>::RedirectEdges(NodeId src, NodeId from, NodeId to) {
+  const auto& edges = nodes_[src].edges_;
+  auto fromRange = EdgeRange(src, nodes_[from].GetValue());
+  if (fromRange.first == fromRange.second) {
+    return false;
+  }
+  auto toRange = EdgeRange(src, nodes_[to].GetValue());
+
+  // Both runs are sorted by weight
+  std::pmr::vector<Edge> added(GetResource());
+  auto j = toRange.first;
+  for (auto i = fromRange.first; i < fromRange.second; ++i) {
+    const auto& w = edges.Weight(i);
+    fingerprint_ -= HashEdge(src, from, w);
+    while (j < toRange.second && edges.Weight(j) < w) {
+      ++j;
     }
-    if ((*it)->GetValue() == dst) {
-      dstFound = true;
+    if (j == toRange.second || !(edges.Weight(j) == w)) {
+      added.push_back(Edge{to, w});
     }
   }
-  if (srcNode == nodeList_.end() || !dstFound) {
-    throw std::runtime_error("Cannot call Graph::IsConnected if src or dst node don't "
-                             "exist in the graph");
-  }
-
-  // Check srcNode edge list
-  auto edges = (*srcNode)->GetEdges();
-  if (!edges[dst].empty()) {
-    return true;
+  nodes_.Mutable(src).edges_.Erase(fromRange.first, fromRange.second);
+  RemoveInEdges(from, fromRange.second - fromRange.first);
+  MergeEdges(src, added);
+  if (toRange.first != toRange.second) {
+    // from and to become one child
+    --nodes_.Mutable(src).children_;
   }
-  return false;
+  return toRange.first == toRange.second;
 }
 
 /**
- * Returns a vector of all nodes in the graph. Sorted by increasing order of
- * node.
+ * Moves the run of src's edges to oldNode to where newNode sorts, so the
+ * edges stay in order once the destination is renamed. Must be called before
+ * the destination's value changes, and newNode must not already be a node.
+ *
+ * @param src - source node
+ * @param newNode - new dst
+ * @param oldNode - old dst
  */
 template <typename N, typename E>
-std::vector<N> gdwg::Graph<N, E>::GetNodes() {
-  std::vector<N> res;
-  for (const auto& node : nodeList_) {
-    res.push_back(node->GetValue());
+void gdwg::Graph<N, E>::UpdateEdges(NodeId src, const N& newNode, const N& oldNode) {
+  auto& edges = nodes_.Mutable(src).edges_;
+  auto range = EdgeRange(src, oldNode);
+  auto pos = partitionPoint(0, edges.Size(), [this, &edges, &newNode](std::size_t i) {
+    return nodes_[edges.Dst(i)].GetValue() < newNode;
+  });
+  if (pos < range.first) {
+    edges.Rotate(pos, range.first, range.second);
+  } else if (range.second < pos) {
+    edges.Rotate(range.first, range.second, pos);
   }
-  std::sort(res.begin(), res.end());
-  return res;
 }
 
 /**
- * Returns a vector of the nodes (found from any immediate outgoing edge)
- * connected to the src node passed in. Sorted by increasing order of node
- * (of those nodes that are connected).
+ * Merges a batch of new edges into src's edges in one pass
  *
  * @param src - source node
+ * @param added - edges sorted by destination then weight, none of which
+ * already exist
  */
 template <typename N, typename E>
-std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) {
-  std::vector<N> res;
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if ((*it)->GetValue() == src) {
-      auto children = (*it)->GetChildren();
-      for (auto dst = children.begin(); dst != children.end(); ++dst) {
-        if (auto dstShared = dst->lock()) {
-          res.push_back(dstShared->GetValue());
-        }
-      }
-
-      std::sort(res.begin(), res.end());
-      return res;
+void gdwg::Graph<N, E>::MergeEdges(NodeId src, const std::pmr::vector<Edge>& added) {
+  for (const auto& edge : added) {
+    fingerprint_ += HashEdge(src, edge.dst, edge.weight);
+  }
+  auto& edges = nodes_.Mutable(src).edges_;
+  edges.Merge(added, [this](NodeId d1, const E& w1, NodeId d2, const E& w2) {
+    if (d1 != d2) {
+      return nodes_[d1].GetValue() < nodes_[d2].GetValue();
     }
+    return w1 < w2;
+  });
+  for (const auto& edge : added) {
+    AddInEdges(edge.dst, 1);
   }
-  throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the "
-                          "graph");
 }
 
 /**
- * Returns a vector of the weights of edges between two nodes. Sorted by
- * increasing order of edge. These edges are all outgoing edges of src toward
- * dst.
+ * Removes a batch of edges from src's edges in one pass
  *
  * @param src - source node
- * @param dst - destination node
- * @return
+ * @param removed - edges sorted by destination then weight, all of which
+ * exist
  */
 template <typename N, typename E>
-std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) {
-  auto srcNode = nodeList_.end();
-  bool dstFound = false;
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if ((*it)->GetValue() == src) {
-      srcNode = it;
-    }
-    if ((*it)->GetValue() == dst) {
-      dstFound = true;
-    }
+void gdwg::Graph<N, E>::EraseEdges(NodeId src, const std::vector<Edge>& removed) {
+  for (const auto& edge : removed) {
+    fingerprint_ -= HashEdge(src, edge.dst, edge.weight);
   }
-  if (srcNode == nodeList_.end() || !dstFound) {
-    throw std::out_of_range("Cannot call Graph::GetWeights if src or dst node don't exist"
-                            " in the graph");
+  auto& edges = nodes_.Mutable(src).edges_;
+  auto next = removed.begin();
+  edges.Filter([&edges, &next, &removed](std::size_t i) {
+    if (next != removed.end() && next->dst == edges.Dst(i) && next->weight == edges.Weight(i)) {
+      ++next;
+      return false;
+    }
+    return true;
+  });
+  for (const auto& edge : removed) {
+    RemoveInEdges(edge.dst, 1);
   }
-
-  // return src-dst edge list
-  auto srcEdges = (*srcNode)->GetEdges();
-  return srcEdges[dst];
 }
 
+// Graph Functions
 /**
- * Returns an iterator to the found node in the graph. If the edge is not
- * found the equivalent value of gdwg::Graph<N, E>::cend() is returned.
+ * Constructor
+ * Creates an empty graph whose nodes, edges and index are all allocated from
+ * resource. The resource must outlive the graph.
+ *
+ * @param resource - memory resource for the graph's storage
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::find(const N&, const N&, const E&) {
-  // todo
-  return gdwg::Graph<N, E>::const_iterator();
-}
+gdwg::Graph<N, E>::Graph(std::pmr::memory_resource* resource)
+  : nodes_(resource), freeIds_(resource), nodeList_(resource), denseIndex_(resource) {}
 
 /**
- * Deletes an edge from src to dst with weight w, only if the edge exists in
- * the graph. This function returns an boolean as to whether the item has
- * been removed or not (true if removed). If the edge is not in the graph it
- * returns false.
+ * Constructor
+ * Takes the start and end of a const_iterator to a std:vector<N> and adds those
+ * nodes to the graph.
+ * @param c1 - beginning of vector of node values
+ * @param c2 - end of vector of node values
+ * @param resource - memory resource for the graph's storage
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(typename std::vector<N>::const_iterator c1,
+                         typename std::vector<N>::const_iterator c2,
+                         std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  // Duplicates in the initialiser vector are skipped by LoadNodes
+  std::pmr::vector<N> values{c1, c2, GetResource()};
+  sortUnique(values);
+  LoadNodes(values);
+}
+
+/**
+ * Constructor
+ * Iterators over tuples of (source node, destination node, edge weight) and
+ * adds them to the graph. The tuples are sorted and deduplicated once, then
+ * loaded in a single pass, so this takes O(E log E).
+ *
+ * @param c1 - beginning of vector of tuples
+ * @param c2 - end of over vector of tuples
+ * @param resource - memory resource for the graph's storage
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator c1,
+                         typename std::vector<std::tuple<N, N, E>>::const_iterator c2,
+                         std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  std::pmr::vector<std::tuple<N, N, E>> edges{c1, c2, GetResource()};
+  sortUnique(edges);
+  LoadEdges(edges.cbegin(), edges.cend());
+}
+
+/**
+ * Constructor
+ * Same as the tuple constructor, but the tuples must already be sorted by
+ * (source node, destination node, edge weight) with no duplicates, e.g. a
+ * snapshot written out by iterating a graph. The sort is skipped, so nodes
+ * are the only thing sorted.
+ *
+ * @param c1 - beginning of vector of sorted, unique tuples
+ * @param c2 - end of vector of sorted, unique tuples
+ * @param resource - memory resource for the graph's storage
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(sorted_unique_t,
+                         typename std::vector<std::tuple<N, N, E>>::const_iterator c1,
+                         typename std::vector<std::tuple<N, N, E>>::const_iterator c2,
+                         std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  LoadEdges(c1, c2);
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(std::initializer_list<N> args, std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  std::pmr::vector<N> values{args, GetResource()};
+  sortUnique(values);
+  LoadNodes(values);
+}
+
+/**
+ * Copy Constructor
+ * Like the std::pmr containers, the copy uses the default memory resource
+ * rather than g's. If g uses it too, the copy shares g's storage and takes
+ * O(1), otherwise g is copied in one pass over its nodes and edges.
+ *
+ * @param g - graph being copied
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(const gdwg::Graph<N, E>& g) {
+  if (*GetResource() == *g.GetResource()) {
+    ShareFrom(g);
+  } else {
+    CopyFrom(g);
+  }
+}
+
+/**
+ * Move Constructor
+ * The moved graph keeps g's memory resource.
+ *
+ * @param g - graph being moved
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& g)
+  : nodes_(std::move(g.nodes_)), freeIds_(std::move(g.freeIds_)),
+    nodeList_(std::move(g.nodeList_)), denseIndex_(std::move(g.denseIndex_)),
+    fingerprint_(std::exchange(g.fingerprint_, 0)),
+    edgeCount_(std::exchange(g.edgeCount_, 0)) {}
+
+/**
+ * Destructor
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>::~Graph() {
+  // Nodes are owned by the slab, so dropping it is enough
+  Clear();
+}
+
+/**
+ * A copy assignment operator overload
+ * The graph keeps its own memory resource, so it can only share g's storage
+ * if both graphs use the same resource. Otherwise g is copied.
+ *
+ * @param g - graph being copy assigned
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& g) {
+  if (&g == this) {
+    return *this;
+  }
+  if (*GetResource() == *g.GetResource()) {
+    ShareFrom(g);
+  } else {
+    Clear();
+    CopyFrom(g);
+  }
+  return *this;
+}
+
+/**
+ * A move assignment operator overload
+ * The graph keeps its own memory resource, so g's storage can only be taken
+ * over if both graphs use the same resource. Otherwise g is copied.
+ *
+ * @param g - graph being move assigned
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(gdwg::Graph<N, E>&& g) {
+  if (&g == this) {
+    return *this;
+  }
+  if (*GetResource() != *g.GetResource()) {
+    return *this = static_cast<const Graph&>(g);
+  }
+  this->nodes_ = std::move(g.nodes_);
+  this->freeIds_ = std::move(g.freeIds_);
+  this->nodeList_ = std::move(g.nodeList_);
+  this->denseIndex_ = std::move(g.denseIndex_);
+  this->fingerprint_ = std::exchange(g.fingerprint_, 0);
+  this->edgeCount_ = std::exchange(g.edgeCount_, 0);
+  return *this;
+}
+
+/**
+ * Fills an empty graph with the given node values in one pass, rather than
+ * one sorted insert per node. The ids handed out are 0..values.size() - 1, in
+ * order of value.
+ *
+ * @param values - sorted, unique node values
+ */
+template <typename N, typename E>
+template <typename Values>
+void gdwg::Graph<N, E>::LoadNodes(const Values& values) {
+  nodes_.Reserve(values.size());
+  nodeList_.Mutable().reserve(values.size());
+  for (const auto& val : values) {
+    auto id = AllocateNode(val);
+    nodeList_.Mutable().push_back(id);
+  }
+}
+
+/**
+ * Makes this graph a copy of g in O(1) by sharing all of g's storage. Either
+ * graph copies a piece of the storage the first time it writes to it, so
+ * neither sees the other's changes. The graphs must use equal resources.
+ *
+ * @param g - graph being copied
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::ShareFrom(const Graph& g) {
+  nodes_ = g.nodes_;
+  freeIds_ = g.freeIds_;
+  nodeList_ = g.nodeList_;
+  denseIndex_ = g.denseIndex_;
+  fingerprint_ = g.fingerprint_;
+  edgeCount_ = g.edgeCount_;
+}
+
+/**
+ * Fills an empty graph with a copy of g in O(V + E). Live nodes are copied in
+ * order of value, so they get the ids 0..V - 1 and deleted slots are dropped.
+ * Edges, parents and the dense index are then copied with every id remapped,
+ * and nothing is looked up by value.
+ *
+ * @param g - graph being copied
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::CopyFrom(const Graph& g) {
+  std::vector<NodeId> newId(g.nodes_.Size(), NO_NODE);
+  auto& nodeList = nodeList_.Mutable();
+  nodes_.Reserve(g.nodeList_->size());
+  nodeList.reserve(g.nodeList_->size());
+  for (auto id : *g.nodeList_) {
+    newId[id] = nodes_.Size();
+    nodeList.push_back(nodes_.Size());
+    nodes_.EmplaceBack(g.nodes_[id].GetValue(), GetResource());
+  }
+
+  // The fingerprint and counts don't depend on ids, so they carry over
+  fingerprint_ = g.fingerprint_;
+  edgeCount_ = g.edgeCount_;
+  auto remap = [&newId](NodeId id) { return newId[id]; };
+  for (std::size_t i = 0; i < nodeList.size(); ++i) {
+    const auto& from = g.nodes_[(*g.nodeList_)[i]];
+    auto& node = nodes_.Mutable(i);
+    node.parents_.reserve(from.parents_.size());
+    node.edges_.AssignMapped(from.edges_, remap);
+    node.children_ = from.children_;
+    node.inEdges_ = from.inEdges_;
+  }
+  // The new ids don't keep the order of the old ones, so parents are listed
+  // again from the edges, which visits them in order of id
+  for (NodeId i = 0; i < nodeList.size(); ++i) {
+    const auto& edges = nodes_[i].edges_;
+    for (std::size_t e = 0; e < edges.Size(); ++e) {
+      if (e == 0 || edges.Dst(e) != edges.Dst(e - 1)) {
+        nodes_.Mutable(edges.Dst(e)).parents_.push_back(i);
+      }
+    }
+  }
+
+  if constexpr (dense_node_ids_v<N>) {
+    auto& index = denseIndex_.Mutable();
+    index.resize(g.denseIndex_->size());
+    std::transform(g.denseIndex_->begin(), g.denseIndex_->end(), index.begin(),
+                   [&newId](NodeId id) { return id == NO_NODE ? NO_NODE : newId[id]; });
+  }
+}
+
+/**
+ * Fills an empty graph with the nodes and edges of the given tuples. Since
+ * the tuples are grouped by source and sorted by destination and weight, each
+ * node's edges can be appended in order without searching.
+ *
+ * @param first - beginning of sorted, unique tuples
+ * @param last - end of sorted, unique tuples
+ */
+template <typename N, typename E>
+template <typename TupleIt>
+void gdwg::Graph<N, E>::LoadEdges(TupleIt first, TupleIt last) {
+  // Sources are already in order, so only the destinations need sorting
+  std::pmr::vector<N> srcs(GetResource());
+  std::pmr::vector<N> dsts(GetResource());
+  for (auto it = first; it != last; ++it) {
+    if (srcs.empty() || srcs.back() < std::get<0>(*it)) {
+      srcs.push_back(std::get<0>(*it));
+    }
+    if (dsts.empty() || !(dsts.back() == std::get<1>(*it))) {
+      dsts.push_back(std::get<1>(*it));
+    }
+  }
+  sortUnique(dsts);
+
+  // values[i] is the value of node i
+  std::pmr::vector<N> values(GetResource());
+  values.reserve(srcs.size() + dsts.size());
+  std::set_union(srcs.begin(), srcs.end(), dsts.begin(), dsts.end(), std::back_inserter(values));
+  LoadNodes(values);
+
+  NodeId src = 0;
+  for (auto run = first; run != last;) {
+    // [run, runEnd) are the edges of one source
+    auto runEnd = std::find_if(run, last, [&run](const std::tuple<N, N, E>& edge) {
+      return std::get<0>(*run) < std::get<0>(edge);
+    });
+    while (nodes_[src].GetValue() < std::get<0>(*run)) {
+      ++src;
+    }
+
+    auto& edges = nodes_.Mutable(src).edges_;
+    edges.Reserve(runEnd - run);
+    NodeId prevDst = NO_NODE;
+    for (; run != runEnd; ++run) {
+      // Integral values go through the dense index, otherwise searching values
+      // is cheaper than searching nodeList_ since it is contiguous
+      NodeId dst;
+      if constexpr (dense_node_ids_v<N>) {
+        dst = FindNode(std::get<1>(*run));
+      } else {
+        dst = std::lower_bound(values.begin(), values.end(), std::get<1>(*run)) - values.begin();
+      }
+      edges.PushBack(dst, std::get<2>(*run));
+      AddInEdges(dst, 1);
+      fingerprint_ += HashEdge(src, dst, std::get<2>(*run));
+      // Parallel edges are adjacent, so each parent is only added once, and
+      // sources come in order of id so the parents stay sorted
+      if (dst != prevDst) {
+        nodes_.Mutable(dst).parents_.push_back(src);
+        ++nodes_.Mutable(src).children_;
+        prevDst = dst;
+      }
+    }
+  }
+}
+
+/**
+ * Adds a new node with value val to the graph. This function returns true if
+ * the node is added to the graph and false if there is already a node
+ * containing val in the graph (with the graph unchanged).
+ *
+ * @param n - node to be inserted
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::InsertNode(const N& n) {
+  // Insert node before every value it is less than
+  auto pos = LowerBoundNode(n);
+  if (pos != nodeList_->end() && !(n < nodes_[*pos].GetValue())) {
+    return false;
+  }
+
+  auto offset = pos - nodeList_->begin();
+  auto id = AllocateNode(n);
+  auto& nodeList = nodeList_.Mutable();
+  nodeList.insert(nodeList.begin() + offset, id);
+  return true;
+}
+
+/**
+ * Adds a new edge src → dst with weight w. This function returns true if the
+ * edge is added and false if the edge src → dst with weight w already exists
+ * in the graph. Note: Nodes are allowed to be connected to themselves.
  *
  * @param src - source node
  * @param dst - destination node
  * @param w - weight of edge
  */
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
-  for (auto it = nodeList_.begin(); it != nodeList_.end(); it++) {
-    if (it->GetValue() == src) {
-      auto edges = it->GetEdges();
-      for (auto edge = edges[dst].begin(); edge != edges[dst].end(); edge++) {
-        if (*edge == w) {
-          edges[dst].erase(edge);
-          return true;
-        }
-      }
-      break;
-    }
+bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  // Find ids of src and dst nodes
+  auto srcNode = FindNode(src);
+  auto dstNode = FindNode(dst);
+
+  // Exception Handling
+  if (srcNode == NO_NODE || dstNode == NO_NODE) {
+    throw std::runtime_error("Cannot call Graph::InsertEdge when either "
+                             "src or dst node does not exist");
+  }
+
+  return AddEdge(srcNode, dstNode, w);
+}
+
+/**
+ * Returns the positions of [first, last) ordered by less, with equal values
+ * kept in their original order so the first copy can win
+ *
+ * @param first - beginning of values
+ * @param last - end of values
+ * @param less - ordering of values
+ */
+template <typename It, typename Less>
+std::vector<std::size_t> sortedOrder(It first, It last, Less less) {
+  std::vector<std::size_t> order(last - first);
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [first, &less](std::size_t i, std::size_t j) {
+    return less(first[i], first[j]);
+  });
+  return order;
+}
+
+/**
+ * Adds each node in [first, last) to the graph, as if by InsertNode in
+ * order, but merges all the new nodes into the node list in one pass.
+ * Returns whether each node was added, i.e. false for nodes already in the
+ * graph and repeats within the batch.
+ *
+ * @param first - beginning of node values
+ * @param last - end of node values
+ */
+template <typename N, typename E>
+std::vector<bool> gdwg::Graph<N, E>::InsertNodes(typename std::vector<N>::const_iterator first,
+                                                 typename std::vector<N>::const_iterator last) {
+  std::vector<bool> res(last - first, false);
+  auto& nodeList = nodeList_.Mutable();
+  auto mid = nodeList.size();
+  auto less = [this](NodeId n1, NodeId n2) {
+    return nodes_[n1].GetValue() < nodes_[n2].GetValue();
+  };
+  auto lessValue = [this](NodeId id, const N& val) { return nodes_[id].GetValue() < val; };
+  const N* prev = nullptr;
+  auto existing = nodeList.begin();
+  for (auto i : sortedOrder(first, last, std::less<N>{})) {
+    const auto& val = first[i];
+    if (prev && *prev == val) {
+      continue;
+    }
+    prev = &val;
+    // The batch is walked in order, so the search for each value in the old
+    // nodes can start where the last one ended
+    existing = std::lower_bound(existing, nodeList.begin() + mid, val, lessValue);
+    if (existing != nodeList.begin() + mid && !(val < nodes_[*existing].GetValue())) {
+      continue;
+    }
+    auto offset = existing - nodeList.begin();
+    nodeList.push_back(AllocateNode(val));
+    existing = nodeList.begin() + offset;
+    res[i] = true;
+  }
+
+  std::inplace_merge(nodeList.begin(), nodeList.begin() + mid, nodeList.end(), less);
+  return res;
+}
+
+/**
+ * Adds each edge (src, dst, weight) in [first, last) to the graph, as if by
+ * InsertEdge in order. The edges are grouped by source, and each group is
+ * merged into its source's edges in one pass. Returns whether each edge was
+ * added, i.e. false for edges already in the graph and repeats within the
+ * batch. If any src or dst node does not exist, nothing is added.
+ *
+ * @param first - beginning of edges
+ * @param last - end of edges
+ */
+template <typename N, typename E>
+std::vector<bool> gdwg::Graph<N, E>::InsertEdges(
+    typename std::vector<std::tuple<N, N, E>>::const_iterator first,
+    typename std::vector<std::tuple<N, N, E>>::const_iterator last) {
+  // Look up every node before changing anything. Each distinct value is only
+  // looked up once, and in sorted order so lookups hit nearby index nodes.
+  auto order = sortedOrder(first, last, std::less<std::tuple<N, N, E>>{});
+  auto byDst = sortedOrder(first, last, [](const std::tuple<N, N, E>& e1,
+                                           const std::tuple<N, N, E>& e2) {
+    return std::get<1>(e1) < std::get<1>(e2);
+  });
+  std::vector<NodeId> srcNodes;
+  std::vector<NodeId> dstNodes(last - first);
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const auto& src = std::get<0>(first[order[i]]);
+    if (i == 0 || !(std::get<0>(first[order[i - 1]]) == src)) {
+      srcNodes.push_back(FindNode(src));
+    }
+    const auto& dst = std::get<1>(first[byDst[i]]);
+    if (i == 0 || !(std::get<1>(first[byDst[i - 1]]) == dst)) {
+      dstNodes[byDst[i]] = FindNode(dst);
+    } else {
+      dstNodes[byDst[i]] = dstNodes[byDst[i - 1]];
+    }
+    if (srcNodes.back() == NO_NODE || dstNodes[byDst[i]] == NO_NODE) {
+      throw std::runtime_error("Cannot call Graph::InsertEdges when either "
+                               "src or dst node does not exist");
+    }
+  }
+
+  std::vector<bool> res(last - first, false);
+  auto srcNode = srcNodes.begin();
+  for (auto run = order.begin(); run != order.end(); ++srcNode) {
+    // The edges of one source, sorted by dst and weight
+    const auto& src = std::get<0>(first[*run]);
+    std::pmr::vector<Edge> added(GetResource());
+    for (; run != order.end() && std::get<0>(first[*run]) == src; ++run) {
+      const auto& dst = std::get<1>(first[*run]);
+      const auto& w = std::get<2>(first[*run]);
+      auto dstNode = dstNodes[*run];
+      if (!added.empty() && added.back().dst == dstNode && added.back().weight == w) {
+        continue;
+      }
+      if (FindEdge(*srcNode, dst, w) != nodes_[*srcNode].edges_.Size()) {
+        continue;
+      }
+      // src becomes a parent with its first edge to dst
+      auto range = EdgeRange(*srcNode, dst);
+      if (range.first == range.second && (added.empty() || added.back().dst != dstNode)) {
+        AddParent(dstNode, *srcNode);
+      }
+      added.push_back(Edge{dstNode, w});
+      res[*run] = true;
+    }
+    MergeEdges(*srcNode, added);
+  }
+  return res;
+}
+
+/**
+ * Removes each edge (src, dst, weight) in [first, last) from the graph, as if
+ * by erase in order. The edges are grouped by source and each group is
+ * removed from its source's edges in one pass. Returns whether each edge was
+ * removed, i.e. false for edges that are not in the graph and repeats within
+ * the batch.
+ *
+ * @param first - beginning of edges
+ * @param last - end of edges
+ */
+template <typename N, typename E>
+std::vector<bool> gdwg::Graph<N, E>::EraseEdges(
+    typename std::vector<std::tuple<N, N, E>>::const_iterator first,
+    typename std::vector<std::tuple<N, N, E>>::const_iterator last) {
+  std::vector<bool> res(last - first, false);
+  auto order = sortedOrder(first, last, std::less<std::tuple<N, N, E>>{});
+  for (auto run = order.begin(); run != order.end();) {
+    // [run, runEnd) are the edges of one source, sorted by dst and weight
+    const auto& src = std::get<0>(first[*run]);
+    auto srcNode = FindNode(src);
+    if (srcNode == NO_NODE) {
+      while (run != order.end() && std::get<0>(first[*run]) == src) {
+        ++run;
+      }
+      continue;
+    }
+
+    std::vector<Edge> removed;
+    for (; run != order.end() && std::get<0>(first[*run]) == src; ++run) {
+      const auto& edges = nodes_[srcNode].edges_;
+      auto pos = FindEdge(srcNode, std::get<1>(first[*run]), std::get<2>(first[*run]));
+      if (pos == edges.Size() || (!removed.empty() && removed.back().dst == edges.Dst(pos) &&
+                                  removed.back().weight == edges.Weight(pos))) {
+        continue;
+      }
+      removed.push_back(Edge{edges.Dst(pos), edges.Weight(pos)});
+      res[*run] = true;
+    }
+    EraseEdges(srcNode, removed);
+
+    // Destinations that lost their last edge from src no longer have it as
+    // a parent
+    for (auto edge = removed.begin(); edge != removed.end(); ++edge) {
+      if (edge + 1 != removed.end() && (edge + 1)->dst == edge->dst) {
+        continue;
+      }
+      auto range = EdgeRange(srcNode, nodes_[edge->dst].GetValue());
+      if (range.first == range.second) {
+        RemoveParent(edge->dst, srcNode);
+      }
+    }
+  }
+  return res;
+}
+
+/**
+ * Deletes a given node and all its associated incoming and outgoing edges.
+ * This function does nothing (returns false) if the node that is to be deleted
+ * does not exist in the graph. Incoming edges are found through the node's
+ * parents rather than by searching the graph, so apart from closing the gap
+ * in nodeList_ this takes time in the degree of the node and its neighbours,
+ * and no trace of the node is left behind. Its slot is reused by the next
+ * node inserted.
+ *
+ * @param n - node to be deleted
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::DeleteNode(const N& n) {
+  auto pos = LowerBoundNode(n);
+  if (pos == nodeList_->end() || n < nodes_[*pos].GetValue()) {
+    return false;
+  }
+  auto id = *pos;
+  auto offset = pos - nodeList_->begin();
+  // Writing to a neighbour on a shared page would copy the page away from
+  // under node, so take node's page first
+  const auto& node = nodes_.Mutable(id);
+  fingerprint_ -= HashIncidentEdges(id);
+
+  // Drop the incoming edges so the parents don't keep edges to a dead node
+  for (auto parent : node.GetParents()) {
+    if (parent != id) {
+      auto range = EdgeRange(parent, n);
+      auto& parentNode = nodes_.Mutable(parent);
+      parentNode.edges_.Erase(range.first, range.second);
+      --parentNode.children_;
+      RemoveInEdges(id, range.second - range.first);
+    }
+  }
+
+  // and drop this node from the parents of its children
+  const auto& edges = node.GetEdges();
+  std::size_t run = 0;
+  for (std::size_t i = 0; i < edges.Size(); ++i) {
+    auto dst = edges.Dst(i);
+    if (i + 1 == edges.Size() || edges.Dst(i + 1) != dst) {
+      // [run, i] are the edges to dst
+      RemoveInEdges(dst, i + 1 - run);
+      if (dst != id) {
+        RemoveParent(dst, id);
+      }
+      run = i + 1;
+    }
+  }
+
+  auto& nodeList = nodeList_.Mutable();
+  nodeList.erase(nodeList.begin() + offset);
+  FreeNode(id);
+  return true;
+}
+
+/**
+ * Replaces the original data, oldData, stored at this particular node by the
+ * replacement data, newData. If an exception is not thrown, this function
+ * returns false if a node that contains value newData already exists in the
+ * graph (with the graph unchanged) and true otherwise. Only the node's own
+ * edges and the runs of edges to it in its parents move, so this takes time
+ * in the degrees of the node and its parents.
+ *
+ * @param oldData - to be replaced
+ * @param newData - replaced with
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::Replace(const N& oldData, const N& newData) {
+  // Find old and new node
+  auto old = FindNode(oldData);
+  if (old == NO_NODE) {
+    throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
+  }
+  if (FindNode(newData) != NO_NODE) {
+    return false;
+  }
+
+  {
+    // The terms of the node and its edges all change with its value
+    fingerprint_ -= nodes_[old].hash_ + HashIncidentEdges(old);
+
+    // Re-sort the edges in parents of oldNode while they still see oldData.
+    // Take old's page first so writing to the parents can't copy it away.
+    for (auto parent : nodes_.Mutable(old).GetParents()) {
+      UpdateEdges(parent, newData, oldData);
+    }
+
+    // Replace value and move the node to its new sorted position, only
+    // shifting the nodes between the two
+    auto from = LowerBoundNode(oldData) - nodeList_->cbegin();
+    auto to = LowerBoundNode(newData) - nodeList_->cbegin();
+    auto& nodeList = nodeList_.Mutable();
+    if (from < to) {
+      std::rotate(nodeList.begin() + from, nodeList.begin() + from + 1, nodeList.begin() + to);
+    } else {
+      std::rotate(nodeList.begin() + to, nodeList.begin() + from, nodeList.begin() + from + 1);
+    }
+    UnindexNode(old);
+    nodes_.Mutable(old).value_ = newData;
+    nodes_.Mutable(old).hash_ = HashNode(newData);
+    IndexNode(old);
+
+    fingerprint_ += nodes_[old].hash_ + HashIncidentEdges(old);
+  }
+  return true;
+}
+
+/**
+ * All instances of node oldData in the graph are replaced with instances of
+ * newData. After completing, every incoming and outgoing edge of oldData
+ * becomes an incoming/outgoing edge of newData, except that duplicate edges
+ * must be removed. Each parent's edges to oldData are merged into its edges
+ * to newData in one pass, and likewise oldData's edges into newData's, so
+ * this takes time in the degrees of the two nodes and of oldData's parents.
+ *
+ * @param oldData - to be replaced
+ * @param newData - replaced with
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
+  if (oldData == newData) {
+    return;
+  }
+  // Find ids of nodes through the index
+  auto oldNode = FindNode(oldData);
+  auto newNode = FindNode(newData);
+
+  // Exception Handling
+  if (oldNode == NO_NODE || newNode == NO_NODE) {
+    throw std::runtime_error("Cannot call Graph::MergeReplace on old or new data if they "
+                             "don't exist in the graph");
+  }
+
+  // Handle incoming edges of oldNode, self edges are handled with the
+  // outgoing ones. The parents newNode gains come in order of id, so they
+  // are merged into its parents at the end rather than one at a time.
+  // Scratch space comes from the graph's resource too.
+  std::pmr::vector<NodeId> gained(GetResource());
+  for (auto parent : nodes_.Mutable(oldNode).GetParents()) {
+    if (parent != oldNode && RedirectEdges(parent, oldNode, newNode)) {
+      gained.push_back(parent);
+    }
+  }
+  {
+    auto& parents = nodes_.Mutable(newNode).parents_;
+    std::pmr::vector<NodeId> merged(GetResource());
+    merged.reserve(parents.size() + gained.size());
+    std::merge(parents.begin(), parents.end(), gained.begin(), gained.end(),
+               std::back_inserter(merged));
+    parents = std::move(merged);
+    // Only a self edge of oldNode is left pointing at it
+    auto& oldParents = nodes_.Mutable(oldNode).parents_;
+    oldParents.erase(std::remove_if(oldParents.begin(), oldParents.end(),
+                                    [oldNode](NodeId parent) { return parent != oldNode; }),
+                     oldParents.end());
+  }
+
+  // Handle outgoing edges of oldNode. Those to oldNode or newNode both become
+  // self edges of newNode, so they are merged into one run at newNode's place
+  // and the rest keep their order.
+  const auto& oldEdges = nodes_.Mutable(oldNode).GetEdges();
+  auto selfRange = EdgeRange(oldNode, oldData);
+  std::pmr::vector<Edge> moved(GetResource());
+  moved.reserve(oldEdges.Size());
+  for (std::size_t i = 0; i < oldEdges.Size(); ++i) {
+    if (i < selfRange.first || i >= selfRange.second) {
+      moved.push_back(Edge{oldEdges.Dst(i), oldEdges.Weight(i)});
+    }
+  }
+  if (selfRange.first != selfRange.second) {
+    auto toNew = std::make_pair(
+        std::partition_point(moved.begin(), moved.end(),
+                             [this, &newData](const Edge& e) {
+                               return nodes_[e.dst].GetValue() < newData;
+                             }),
+        moved.end());
+    toNew.second = std::find_if(toNew.first, moved.end(),
+                                [newNode](const Edge& e) { return e.dst != newNode; });
+    std::pmr::vector<Edge> self(GetResource());
+    for (auto i = selfRange.first; i < selfRange.second; ++i) {
+      self.push_back(Edge{newNode, oldEdges.Weight(i)});
+    }
+    std::pmr::vector<Edge> run(GetResource());
+    std::merge(toNew.first, toNew.second, self.begin(), self.end(), std::back_inserter(run),
+               [](const Edge& lhs, const Edge& rhs) { return lhs.weight < rhs.weight; });
+    auto sameWeight = [](const Edge& lhs, const Edge& rhs) { return lhs.weight == rhs.weight; };
+    run.erase(std::unique(run.begin(), run.end(), sameWeight), run.end());
+    for (auto& edge : run) {
+      edge.dst = newNode;
+    }
+    auto at = moved.erase(toNew.first, toNew.second);
+    moved.insert(at, run.begin(), run.end());
+  }
+
+  // Drop the edges newNode already has, and note the destinations it gains.
+  // Take newNode's page first so adding parents can't copy it away.
+  const auto& newEdges = nodes_.Mutable(newNode).GetEdges();
+  std::pmr::vector<Edge> added(GetResource());
+  std::size_t j = 0;
+  for (const auto& edge : moved) {
+    // Both are sorted by destination then weight
+    const auto& dst = nodes_[edge.dst].GetValue();
+    while (j < newEdges.Size() &&
+           (nodes_[newEdges.Dst(j)].GetValue() < dst ||
+            (newEdges.Dst(j) == edge.dst && newEdges.Weight(j) < edge.weight))) {
+      ++j;
+    }
+    if (j < newEdges.Size() && newEdges.Dst(j) == edge.dst && newEdges.Weight(j) == edge.weight) {
+      continue;
+    }
+    // newNode's edges to dst, if any, are a run next to j
+    bool connected = (j < newEdges.Size() && newEdges.Dst(j) == edge.dst) ||
+                     (j > 0 && newEdges.Dst(j - 1) == edge.dst);
+    if (!connected && (added.empty() || added.back().dst != edge.dst)) {
+      AddParent(edge.dst, newNode);
+    }
+    added.push_back(edge);
+  }
+  MergeEdges(newNode, added);
+
+  // Unlinks what is left, i.e. the old self edges and outgoing edges
+  DeleteNode(oldData);
+}
+
+/**
+ * Remove all nodes and edges from the graph. New nodes or edges can be added
+ * to the graph afterwards.
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Clear() {
+  nodes_.Clear();
+  freeIds_.Reset();
+  nodeList_.Reset();
+  denseIndex_.Reset();
+  fingerprint_ = 0;
+  edgeCount_ = 0;
+}
+
+/**
+ * Writes the graph in the format of operator<< straight from the node and
+ * edge storage, through a TextWriter
+ *
+ * @param sink - sink(data, size) writes data out, returning false on failure
+ * @return false if any write failed
+ */
+template <typename N, typename E>
+template <typename Sink>
+bool gdwg::Graph<N, E>::WriteText(Sink sink) const {
+  TextWriter<Sink> out{sink};
+  for (auto id : *nodeList_) {
+    const auto& node = nodes_[id];
+    out.Write(node.GetValue());
+    out.Write(" (");
+    const auto& edges = node.GetEdges();
+    for (std::size_t i = 0; i < edges.Size(); ++i) {
+      out.Write("\n  ");
+      out.Write(nodes_[edges.Dst(i)].GetValue());
+      out.Write(" | ");
+      out.Write(edges.Weight(i));
+    }
+    out.Write("\n)\n");
+  }
+  return out.Flush();
+}
+
+/**
+ * Writes the graph to out exactly as operator<< would, in large blocks and
+ * without allocating. Returns false if writing failed part way.
+ *
+ * @param out - open file to write to
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::Dump(std::FILE* out) const {
+  return WriteText([out](const char* data, std::size_t size) {
+    return std::fwrite(data, 1, size, out) == size;
+  });
+}
+
+/**
+ * Writes the graph to the file descriptor fd exactly as operator<< would, in
+ * large blocks and without allocating. Returns false if writing failed part
+ * way.
+ *
+ * @param fd - file descriptor open for writing
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::Dump(int fd) const {
+  return WriteText([fd](const char* data, std::size_t size) {
+    while (size > 0) {
+      auto written = ::write(fd, data, size);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      data += written;
+      size -= written;
+    }
+    return true;
+  });
+}
+
+/**
+ * Returns the header of a saved graph of this type
+ *
+ * @param nodes - number of nodes saved
+ * @param edges - number of edges saved
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::SaveHeader gdwg::Graph<N, E>::MakeSaveHeader(std::uint64_t nodes,
+                                                                       std::uint64_t edges) {
+  SaveHeader header{};
+  std::memcpy(header.magic, "GDWG", sizeof(header.magic));
+  header.version = 2;
+  header.byteOrder = 0x01020304;
+  header.nodeSize = BITWISE_NODES ? sizeof(N) : 0;
+  header.weightSize = BITWISE_WEIGHTS ? sizeof(E) : 0;
+  header.nodes = nodes;
+  header.edges = edges;
+  return header;
+}
+
+/**
+ * Writes a binary snapshot of the graph to path for Load to read back. After
+ * a header, the file holds the node values in order, CSR offsets of each
+ * node's edges, each edge's destination as an index into the node values,
+ * the weights, and a checksum of everything before it. Each part is padded
+ * to SAVE_ALIGNMENT bytes, so when N and E are bitwise a MappedGraph can use
+ * the file as it is. Node values and weights are written with Serializer<N>
+ * and Serializer<E>. Each node's edges are written straight from its own
+ * storage, so nothing the size of the graph is built on the side. The file
+ * is written to path + ".tmp" and only renamed to path once it is complete,
+ * so a failed save leaves any earlier file at path as it was. Throws
+ * std::runtime_error if the file can't be written.
+ *
+ * @param path - file to write, replaced if it exists
+ */
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Save(const std::string& path) const {
+  auto tmpPath = path + ".tmp";
+  try {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{std::fopen(tmpPath.c_str(), "wb"),
+                                                         &std::fclose};
+    if (!file) {
+      throw std::runtime_error("Cannot call Graph::Save on a path that can't be written");
+    }
+    // BinaryWriter already writes in large blocks
+    std::setvbuf(file.get(), nullptr, _IONBF, 0);
+
+    const auto& nodeList = *nodeList_;
+    std::vector<NodeId> index(nodes_.Size());
+    for (std::size_t i = 0; i < nodeList.size(); ++i) {
+      index[nodeList[i]] = i;
+    }
+
+    BinaryWriter out{file.get()};
+    out.WriteValue(MakeSaveHeader(nodeList.size(), edgeCount_));
+    out.Align(SAVE_ALIGNMENT);
+    for (auto id : nodeList) {
+      Serializer<N>::Write(out, nodes_[id].GetValue());
+    }
+    out.Align(SAVE_ALIGNMENT);
+    std::uint64_t offset = 0;
+    out.WriteValue(offset);
+    for (auto id : nodeList) {
+      offset += nodes_[id].GetEdges().Size();
+      out.WriteValue(offset);
+    }
+    out.Align(SAVE_ALIGNMENT);
+    // Destinations are remapped one node at a time
+    std::vector<NodeId> column;
+    for (auto id : nodeList) {
+      const auto& edges = nodes_[id].GetEdges();
+      column.resize(edges.Size());
+      for (std::size_t i = 0; i < edges.Size(); ++i) {
+        column[i] = index[edges.Dst(i)];
+      }
+      out.WriteBytes(column.data(), column.size() * sizeof(NodeId));
+    }
+    out.Align(SAVE_ALIGNMENT);
+    for (auto id : nodeList) {
+      const auto& edges = nodes_[id].GetEdges();
+      if constexpr (BITWISE_WEIGHTS) {
+        // Straight from the node's weight column
+        out.WriteBytes(edges.WeightCursor(0), edges.Size() * sizeof(E));
+      } else {
+        for (std::size_t i = 0; i < edges.Size(); ++i) {
+          Serializer<E>::Write(out, edges.Weight(i));
+        }
+      }
+    }
+    out.Align(SAVE_ALIGNMENT);
+    out.Finish();
+    if (std::fclose(file.release()) != 0 || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+      throw std::runtime_error("Cannot call Graph::Save on a path that can't be written");
+    }
+  } catch (...) {
+    std::remove(tmpPath.c_str());
+    throw;
+  }
+}
+
+/**
+ * Reads a graph written by Save from a graph of the same N and E. The file
+ * is read into flat columns and its checksum verified before anything is
+ * built. Nodes and edges are then loaded in order, as the copy constructor
+ * does, with nothing looked up or sorted. Throws std::runtime_error if the
+ * file can't be read or isn't an intact saved graph of this type.
+ *
+ * @param path - file written by Save
+ * @param resource - memory resource for the graph's storage
+ */
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::Graph<N, E>::Load(const std::string& path,
+                                          std::pmr::memory_resource* resource) {
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{std::fopen(path.c_str(), "rb"),
+                                                       &std::fclose};
+  if (!file || std::fseek(file.get(), 0, SEEK_END) != 0) {
+    throw std::runtime_error("Cannot call Graph::Load on a path that can't be read");
+  }
+  auto fileSize = static_cast<std::uint64_t>(std::ftell(file.get()));
+  std::rewind(file.get());
+  // BinaryReader already reads in large blocks
+  std::setvbuf(file.get(), nullptr, _IONBF, 0);
+
+  BinaryReader in{file.get()};
+  auto header = in.ReadValue<SaveHeader>();
+  in.Align(SAVE_ALIGNMENT);
+  auto expected = MakeSaveHeader(header.nodes, header.edges);
+  if (std::memcmp(&header, &expected, sizeof(header)) != 0) {
+    throw std::runtime_error("Cannot call Graph::Load on a file that isn't a saved graph of this "
+                             "type");
+  }
+  // The offsets and destinations alone fill this much of the file, which
+  // bounds the allocations below
+  if (header.nodes >= NO_NODE || header.edges > fileSize / sizeof(NodeId) ||
+      (header.nodes + 1) * sizeof(std::uint64_t) + header.edges * sizeof(NodeId) > fileSize) {
+    throw std::runtime_error("Cannot call Graph::Load on a corrupt file");
+  }
+
+  std::vector<N> values;
+  values.reserve(header.nodes);
+  for (std::uint64_t i = 0; i < header.nodes; ++i) {
+    values.push_back(Serializer<N>::Read(in));
+  }
+  in.Align(SAVE_ALIGNMENT);
+  std::vector<std::uint64_t> offsets(header.nodes + 1);
+  in.ReadBytes(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+  in.Align(SAVE_ALIGNMENT);
+  std::vector<NodeId> dsts(header.edges);
+  in.ReadBytes(dsts.data(), dsts.size() * sizeof(NodeId));
+  in.Align(SAVE_ALIGNMENT);
+  std::vector<E> weights;
+  if constexpr (BITWISE_WEIGHTS) {
+    weights.resize(header.edges);
+    in.ReadBytes(weights.data(), weights.size() * sizeof(E));
+  } else {
+    weights.reserve(header.edges);
+    for (std::uint64_t i = 0; i < header.edges; ++i) {
+      weights.push_back(Serializer<E>::Read(in));
+    }
+  }
+  in.Align(SAVE_ALIGNMENT);
+  if (!in.Finish()) {
+    throw std::runtime_error("Cannot call Graph::Load on a corrupt file");
+  }
+
+  // An intact file could still have been written by something other than
+  // Save, so check the order the graph relies on
+  bool ordered = offsets.front() == 0 && offsets.back() == header.edges;
+  for (std::size_t i = 1; ordered && i < values.size(); ++i) {
+    ordered = values[i - 1] < values[i];
+  }
+  for (std::size_t src = 0; ordered && src < values.size(); ++src) {
+    ordered = offsets[src] <= offsets[src + 1];
+    for (auto k = offsets[src]; ordered && k < offsets[src + 1]; ++k) {
+      ordered = dsts[k] < values.size() &&
+                (k == offsets[src] || dsts[k - 1] < dsts[k] ||
+                 (dsts[k - 1] == dsts[k] && weights[k - 1] < weights[k]));
+    }
+  }
+  if (!ordered) {
+    throw std::runtime_error("Cannot call Graph::Load on a corrupt file");
+  }
+
+  // Parent lists are the edges turned around, gathered with a counting sort
+  // so that each node is then visited once, in order
+  std::vector<std::uint64_t> parentOffsets(values.size() + 1);
+  std::vector<std::size_t> children(values.size());
+  std::vector<std::size_t> inEdges(values.size());
+  for (std::size_t src = 0; src < values.size(); ++src) {
+    for (auto k = offsets[src]; k < offsets[src + 1]; ++k) {
+      // Parallel edges are adjacent, so each parent is only counted once
+      bool first = k == offsets[src] || dsts[k] != dsts[k - 1];
+      parentOffsets[dsts[k] + 1] += first;
+      children[src] += first;
+      ++inEdges[dsts[k]];
+    }
+  }
+  std::partial_sum(parentOffsets.begin(), parentOffsets.end(), parentOffsets.begin());
+  std::vector<NodeId> parents(parentOffsets.back());
+  auto nextParent = parentOffsets;
+  for (NodeId src = 0; src < values.size(); ++src) {
+    for (auto k = offsets[src]; k < offsets[src + 1]; ++k) {
+      if (k == offsets[src] || dsts[k] != dsts[k - 1]) {
+        parents[nextParent[dsts[k]]++] = src;
+      }
+    }
+  }
+
+  Graph g{resource};
+  g.LoadNodes(values);
+  std::vector<std::uint64_t> hashes(values.size());
+  for (NodeId id = 0; id < values.size(); ++id) {
+    auto& node = g.nodes_.Mutable(id);
+    hashes[id] = node.hash_;
+    node.parents_.assign(parents.begin() + parentOffsets[id],
+                         parents.begin() + parentOffsets[id + 1]);
+    node.edges_.Assign(dsts.data() + offsets[id], weights.data() + offsets[id],
+                       offsets[id + 1] - offsets[id]);
+    node.children_ = children[id];
+    node.inEdges_ = inEdges[id];
+  }
+  g.edgeCount_ = header.edges;
+  if constexpr (hashable_v<N> && hashable_v<E>) {
+    for (std::size_t src = 0; src < values.size(); ++src) {
+      for (auto k = offsets[src]; k < offsets[src + 1]; ++k) {
+        g.fingerprint_ += HashEdge(hashes[src], hashes[dsts[k]], weights[k]);
+      }
+    }
+  }
+  return g;
+}
+
+/**
+ * Returns true if a node with value val exists in the graph and false
+ * otherwise.
+ * @param val - value of potential node
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::IsNode(const N& val) {
+  return FindNode(val) != NO_NODE;
+}
+
+/**
+ * Returns true if the edge src → dst exists in the graph and false otherwise.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ * @return
+ */
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE || !IsNode(dst)) {
+    throw std::runtime_error("Cannot call Graph::IsConnected if src or dst node don't "
+                             "exist in the graph");
+  }
+
+  // Check srcNode edge list, destinations without edges are never kept
+  auto range = EdgeRange(srcNode, dst);
+  return range.first != range.second;
+}
+
+/**
+ * Returns a vector of all nodes in the graph. Sorted by increasing order of
+ * node.
+ */
+template <typename N, typename E>
+std::vector<N> gdwg::Graph<N, E>::GetNodes() {
+  // nodeList_ is already ordered by value
+  std::vector<N> res;
+  res.reserve(nodeList_->size());
+  for (auto id : *nodeList_) {
+    res.push_back(nodes_[id].GetValue());
   }
-  return false;
+  return res;
 }
 
 /**
- * This function removes the edge at the location the iterator points to.
- * This function returns an iterator to the element AFTER the one that has
- * been removed. If no erase can be made, the equivalent of gdwg::Graph<N,
- * E>::end() is returned.
+ * Returns a vector of the nodes (found from any immediate outgoing edge)
+ * connected to the src node passed in. Sorted by increasing order of node
+ * (of those nodes that are connected).
  *
- * @param iterator
+ * @param src - source node
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator
-gdwg::Graph<N, E>::erase(gdwg::Graph<N, E>::const_iterator it) {
-  it;
-  // todo
-  return gdwg::Graph<N, E>::const_iterator();
+std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) {
+  auto connected = GetConnectedView(src);
+  return {connected.begin(), connected.end()};
 }
 
-// const_iterator
-
 /**
- * Pre-increment Operator overload for const_iterator
+ * Returns a view of the nodes connected to src by an outgoing edge, in
+ * increasing order of node. Unlike GetConnected nothing is copied, but the
+ * view is only valid until the graph is next modified.
+ *
+ * @param src - source node
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator++() {
-  std::cout << (*node_iter_)->GetValue() << " -> " << *edge_iter_ << " = " <<
-  *weight_iter_ << "\n";
-
-  std::cout << "incrementing weight!\n";
-  ++weight_iter_;
-
-  std::vector<N> children;
-  for (const auto& child : (*node_iter_)->GetChildren()) {
-    auto child_lock = child.lock();
-    children.push_back(child_lock->GetValue());
-  }
-  std::map<N, std::vector<E>> edge_map = (*node_iter_)->GetEdges();
-  std::vector<E> weights = edge_map[*edge_iter_];
-
-  if (weight_iter_ == weights.end()) {
-//    std::cout << "incrementing edge!\n";
-    ++edge_iter_;
-    if (edge_iter_ == children.end()) {
-      do {
-//        std::cout << "incrementing node!\n";
-        ++node_iter_;
-      } while (node_iter_ != node_sentinel_ && children.begin() == children.end());
-
-      if (node_iter_ != node_sentinel_) {
-        children.clear();
-        for (const auto& child : (*node_iter_)->GetChildren()) {
-          auto child_lock = child.lock();
-          children.push_back(child_lock->GetValue());
-        }
-        edge_iter_ = children.begin();
-
-        std::map<N, std::vector<E>> edges = (*node_iter_)->GetEdges();
-        weights = edges[*edge_iter_];
-        weight_iter_ = weights.begin();
-
-      } else {
-        //TODO return cend()???
-      }
-    }
+typename gdwg::Graph<N, E>::connected_view
+gdwg::Graph<N, E>::GetConnectedView(const N& src) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the "
+                            "graph");
   }
-
-  std::cout << (*node_iter_)->GetValue() << " -> " << *edge_iter_ << " = " <<
-            *weight_iter_ << "\n";
-  return *this;
+  const auto& edges = nodes_[srcNode].GetEdges();
+  return {connected_iterator{this, &edges, 0}, connected_iterator{this, &edges, edges.Size()}};
 }
 
 /**
- * Pre-decrement Operator overload for const_iterator
+ * Returns a vector of the weights of edges between two nodes. Sorted by
+ * increasing order of edge. These edges are all outgoing edges of src toward
+ * dst.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ * @return
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator--() {
-  std::vector<N> children;
-  for (const auto& child : (*node_iter_)->GetChildren()) {
-    children.push_back(child->GetValue());
+std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE || FindNode(dst) == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::GetWeights if src or dst node don't exist"
+                            " in the graph");
   }
-  std::map<N, std::vector<E>> edge_map = (*node_iter_)->GetEdges();
-  std::vector<E> weights = edge_map[*edge_iter_];
-
-  if (weight_iter_ == weights.begin()) {
-    if (edge_iter_ == children.begin()) {
-      do {
-        --node_iter_;
-      } while (node_iter_ != reverse_sentinel_ && children.begin() == children.end());
-
-      if (children.begin() != children.end()) {
-        children = (*node_iter_)->GetChildren();
-        edge_map = (*node_iter_)->GetEdges();
 
-        edge_iter_ = children.end();
-        --edge_iter_;
-
-        weight_iter_ = edge_map[*edge_iter_].end();
-        --weight_iter_;
-
-      } else if (node_iter_ == reverse_sentinel_) {
-        throw std::runtime_error("Cannot cannot decrement past begin().");
-      }
-
-    } else {
-      --edge_iter_;
-
-      weight_iter_ = edge_map[*edge_iter_].end();
-      --weight_iter_;
-    }
+  // Copies the run straight out of the weight column if there is one
+  auto range = EdgeRange(srcNode, dst);
+  return nodes_[srcNode].GetEdges().Weights(range.first, range.second);
+}
 
-  } else {
-    --weight_iter_;
+/**
+ * Returns a view of the weights of edges src → dst in increasing order of
+ * edge. Unlike GetWeights nothing is copied, but the view is only valid until
+ * the graph is next modified.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::weights_view gdwg::Graph<N, E>::GetWeightsView(const N& src,
+                                                                          const N& dst) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE || FindNode(dst) == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::GetWeights if src or dst node don't exist"
+                            " in the graph");
   }
 
-  return *this;
+  // The src-dst edges are one run, empty if they aren't connected
+  auto range = EdgeRange(srcNode, dst);
+  const auto& edges = nodes_[srcNode].GetEdges();
+  return {weight_iterator{edges.WeightCursor(range.first)},
+          weight_iterator{edges.WeightCursor(range.second)}};
 }
 
 /**
- * Post-increment Operator overload for const_iterator
+ * Returns the number of distinct nodes src has an edge to, kept up to date
+ * as edges change, so this is a lookup rather than a scan of the edges
+ *
+ * @param src - source node
  */
 template <typename N, typename E>
-const typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::const_iterator::
-operator++(int) {
-  auto copy{*this};
-  ++(*this);
-  return copy;
+std::size_t gdwg::Graph<N, E>::OutDegree(const N& src) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::OutDegree if src doesn't exist in the graph");
+  }
+  return nodes_[srcNode].children_;
 }
 
 /**
- * Post-decrement Operator overload for const_iterator
+ * Returns the number of distinct nodes with an edge to dst, i.e. its parents
+ *
+ * @param dst - destination node
  */
 template <typename N, typename E>
-const typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::const_iterator::
-operator--(int) {
-  auto copy{*this};
-  --(*this);
-  return copy;
+std::size_t gdwg::Graph<N, E>::InDegree(const N& dst) const {
+  auto dstNode = FindNode(dst);
+  if (dstNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::InDegree if dst doesn't exist in the graph");
+  }
+  return nodes_[dstNode].GetParents().size();
 }
 
 /**
- * * Operator overload for const_iterator
+ * Returns the number of edges out of src, counting parallel edges
+ *
+ * @param src - source node
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator::reference gdwg::Graph<N, E>::const_iterator::
-operator*() const {
-  return {(*node_iter_)->GetValue(), *edge_iter_, *weight_iter_};
+std::size_t gdwg::Graph<N, E>::OutEdgeCount(const N& src) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::OutEdgeCount if src doesn't exist in the graph");
+  }
+  return nodes_[srcNode].GetEdges().Size();
 }
 
 /**
- * Returns a const_iterator pointing to the first in the container. A
- * const_iterator is an iterator that points to const content. This iterator
- * can be increased and decreased (unless it is itself also const), but it
- * cannot be used to modify the contents it points to, even if the content it
- * points to is not itself const.
+ * Returns the number of edges into dst, counting parallel edges, kept up to
+ * date as edges change
+ *
+ * @param dst - destination node
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
-
-  if (nodeList_.size() == 0) {
-    return cend();
+std::size_t gdwg::Graph<N, E>::InEdgeCount(const N& dst) const {
+  auto dstNode = FindNode(dst);
+  if (dstNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::InEdgeCount if dst doesn't exist in the graph");
   }
+  return nodes_[dstNode].inEdges_;
+}
 
-  auto it = nodeList_.begin();
+/**
+ * Returns the out-edges of src with weight in [lo, hi) as (dst, weight)
+ * pairs, in increasing order of weight and then of dst. The edges are found
+ * by binary search of src's weight order, so this takes O(log deg(src) + k)
+ * for k edges, once the order is sorted. It is sorted by the first weight
+ * query after src's edges change, in O(deg(src) log deg(src)).
+ *
+ * @param src - source node
+ * @param lo - least weight returned
+ * @param hi - weights returned are less than this
+ */
+template <typename N, typename E>
+std::vector<std::pair<N, E>> gdwg::Graph<N, E>::GetEdgesByWeight(const N& src, const E& lo,
+                                                                const E& hi) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::GetEdgesByWeight if src doesn't exist in the "
+                            "graph");
+  }
 
-  // find a node that has children
-  while ((*it)->GetChildren().size() == 0) {
-    ++it;
-    if (it == nodeList_.end()) {
-      return cend();
+  const auto& edges = WeightOrdered(srcNode);
+  auto first = partitionPoint(0, edges.Size(), [&edges, &lo](std::size_t i) {
+    return edges.Weight(edges.ByWeight(i)) < lo;
+  });
+  std::vector<std::pair<N, E>> res;
+  for (auto i = first; i < edges.Size(); ++i) {
+    auto pos = edges.ByWeight(i);
+    if (!(edges.Weight(pos) < hi)) {
+      break;
     }
+    res.emplace_back(nodes_[edges.Dst(pos)].GetValue(), edges.Weight(pos));
   }
+  return res;
+}
 
-  std::vector<N> children;
-  for (const auto& child : (*it)->GetChildren()) {
-    auto child_lock = child.lock();
-    children.push_back(child_lock->GetValue());
+/**
+ * Returns the k out-edges of src with the least weights as (dst, weight)
+ * pairs, in increasing order of weight and then of dst, or all of them if src
+ * has fewer than k. Like GetEdgesByWeight this reads src's weight order, so
+ * it takes O(k) once the order is sorted.
+ *
+ * @param src - source node
+ * @param k - number of edges
+ */
+template <typename N, typename E>
+std::vector<std::pair<N, E>> gdwg::Graph<N, E>::GetLightestEdges(const N& src,
+                                                                std::size_t k) const {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    throw std::out_of_range("Cannot call Graph::GetLightestEdges if src doesn't exist in the "
+                            "graph");
   }
-  std::map<N, std::vector<E>> edges = (*it)->GetEdges();
-  std::vector<E> weights = edges.begin()->second;
 
-  // todo what happens when key maps to empty vector
-//  if (weights.size() == 0) {}
+  const auto& edges = WeightOrdered(srcNode);
+  std::vector<std::pair<N, E>> res;
+  res.reserve(std::min(k, edges.Size()));
+  for (std::size_t i = 0; i < edges.Size() && i < k; ++i) {
+    auto pos = edges.ByWeight(i);
+    res.emplace_back(nodes_[edges.Dst(pos)].GetValue(), edges.Weight(pos));
+  }
+  return res;
+}
 
-  std::cout << (*it)->GetValue() << " -> " << *children.begin() << " = " <<
-            *weights.begin() << "\n";
-  return {it, nodeList_.end(), nodeList_.begin(), children.begin(), weights
-  .begin()};
+/**
+ * Returns an iterator to the found node in the graph. If the edge is not
+ * found the equivalent value of gdwg::Graph<N, E>::cend() is returned. The
+ * edge is found by binary search of the source's edges, and the iterator
+ * also needs the source's place in nodeList_, so this takes
+ * O(log V + log deg(src)).
+ *
+ * @param src - source node
+ * @param dst - destination node
+ * @param w - weight of edge
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator
+gdwg::Graph<N, E>::find(const N& src, const N& dst, const E& w) {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    return cend();
+  }
+  auto edge = FindEdge(srcNode, dst, w);
+  if (edge == nodes_[srcNode].GetEdges().Size()) {
+    return cend();
+  }
+  // The bulk constructors, copies and inserts in order give the i-th node
+  // the id i, so try its place before searching for it
+  const auto& nodeList = *nodeList_;
+  auto pos = srcNode < nodeList.size() && nodeList[srcNode] == srcNode
+                 ? nodeList.begin() + srcNode
+                 : LowerBoundNode(src);
+  return {this, pos, nodeList.end(), nodeList.begin(), edge};
 }
 
 /**
- * Returns a const_iterator pointing to the past-the-end element in the
- * container. A const_iterator is an iterator that points to const content.
- * This iterator can be increased and decreased (unless it is itself also
- * const), but it cannot be used to modify the contents it points to, even if
- * the content it points to is not itself const.
- * If the container is empty, this function returns the same as
- * vector::cbegin. The value returned shall not be dereferenced.
+ * Returns true if the edge src → dst with weight w exists in the graph and
+ * false otherwise, including if either node doesn't exist. Unlike find this
+ * looks src up through the node index rather than nodeList_.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ * @param w - weight of edge
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cend() const {
-//  if (nodeList_.size() == 0) {
-//    // todo exit early
-//  }
-//
-//  auto it = nodeList_.end();
-//
-//  // find a node that has children
-//  while ((*it)->GetChildren().size() == 0) {
-//    --it;
-//  }
-//
-//  std::vector<N> children;
-//  for (const auto& child : (*it)->GetChildren()) {
-//    auto child_lock = child.lock();
-//    children.push_back(child_lock->GetValue());
-//  }
-//  std::map<N, std::vector<E>> edges = (*(nodeList_.begin()))->GetEdges();
-//  std::vector<E> last_weights = edges.rbegin()->second;
-//
-//  return const_iterator(nodeList_.end(), nodeList_.end(), nodeList_.begin(), children.end(),
-//                        last_weights.end());
-
-  return {nodeList_.end(), nodeList_.end(), nodeList_.begin(), {}, {}};
+bool gdwg::Graph<N, E>::ContainsEdge(const N& src, const N& dst, const E& w) const {
+  auto srcNode = FindNode(src);
+  return srcNode != NO_NODE && FindEdge(srcNode, dst, w) != nodes_[srcNode].GetEdges().Size();
 }
 
-// const_reverse_iterator
 /**
- * Pre-increment Operator overload for const_reverse_iterator
+ * Deletes an edge from src to dst with weight w, only if the edge exists in
+ * the graph. This function returns an boolean as to whether the item has
+ * been removed or not (true if removed). If the edge is not in the graph it
+ * returns false.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ * @param w - weight of edge
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_reverse_iterator& gdwg::Graph<N, E>::const_reverse_iterator::
-operator++() {
-  ++weight_iter_;
+bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  auto srcNode = FindNode(src);
+  if (srcNode == NO_NODE) {
+    return false;
+  }
+  const auto& edges = nodes_[srcNode].edges_;
+  auto pos = FindEdge(srcNode, dst, w);
+  if (pos == edges.Size()) {
+    return false;
+  }
 
-  std::vector<N> children;
-  for (const auto& child : (*node_iter_)->GetChildren()) {
-    auto child_lock = child.lock();
-    children.push_back(child_lock->GetValue());
+  auto dstNode = edges.Dst(pos);
+  fingerprint_ -= HashEdge(srcNode, dstNode, w);
+  nodes_.Mutable(srcNode).edges_.Erase(pos, pos + 1);
+  RemoveInEdges(dstNode, 1);
+  auto range = EdgeRange(srcNode, dst);
+  if (range.first == range.second) {
+    RemoveParent(dstNode, srcNode);
   }
-  std::map<N, std::vector<E>> edge_map = (*node_iter_)->GetEdges();
-  std::vector<E> weights = edge_map[*edge_iter_];
+  return true;
+}
 
-  if (weight_iter_ == weights.rend()) {
-    ++edge_iter_;
-    if (edge_iter_ == children.rend()) {
-      do {
-        ++node_iter_;
-      } while (node_iter_ != node_sentinel_ && children.rbegin() == children.rend());
+/**
+ * This function removes the edge at the location the iterator points to.
+ * This function returns an iterator to the element AFTER the one that has
+ * been removed. If no erase can be made, the equivalent of gdwg::Graph<N,
+ * E>::end() is returned. The iterator already holds the edge's place, so
+ * nothing is searched for: the source's later edges shift down one, and if
+ * this was its last edge to the destination the source stops being one of
+ * the destination's parents. The returned iterator carries on from the same
+ * place, so `it = g.erase(it)` in a scan visits every edge once. The shift
+ * makes each erase O(out-degree of the source), so pruning d edges of one
+ * node this way takes O(d * out-degree). EraseEdgesIf prunes in one pass.
+ *
+ * @param it - iterator to the edge to remove
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator
+gdwg::Graph<N, E>::erase(gdwg::Graph<N, E>::const_iterator it) {
+  if (it == cend()) {
+    return cend();
+  }
+  auto srcNode = *it.node_iter_;
+  auto pos = it.edge_;
+  auto& edges = nodes_.Mutable(srcNode).edges_;
+  auto dstNode = edges.Dst(pos);
+  fingerprint_ -= HashEdge(srcNode, dstNode, edges.Weight(pos));
+  edges.Erase(pos, pos + 1);
+  RemoveInEdges(dstNode, 1);
+  auto size = edges.Size();
+
+  // The edges to dst were one run, so it is gone if neither neighbour of
+  // the erased edge goes to dst
+  if (!(pos > 0 && edges.Dst(pos - 1) == dstNode) && !(pos < size && edges.Dst(pos) == dstNode)) {
+    RemoveParent(dstNode, srcNode);
+  }
 
-      if (node_iter_ != node_sentinel_) {
-        edge_iter_ = children.rbegin();
+  // The next edge is now at pos, or else the first of a later node
+  auto node = it.node_iter_;
+  if (pos == size) {
+    do {
+      ++node;
+    } while (node != nodeList_->end() && nodes_[*node].GetEdges().Empty());
+    pos = 0;
+  }
+  return {this, node, nodeList_->end(), nodeList_->begin(), pos};
+}
 
-        std::map<N, std::vector<E>> edges = (*node_iter_)->GetEdges();
-        weights = edges[*edge_iter_];
-        weight_iter_ = weights.begin();
+/**
+ * Removes every edge (src, dst, w) for which pred(src, dst, w) is true, in
+ * one pass over each node's edges, so this takes O(V + E) calls to pred
+ * however many edges are removed. Parents are updated once per destination
+ * that loses all its edges from a source.
+ *
+ * @param pred - pred(const N& src, const N& dst, const E& w) returns true
+ * for edges to remove
+ * @return the number of edges removed
+ */
+template <typename N, typename E>
+template <typename Pred>
+std::size_t gdwg::Graph<N, E>::EraseEdgesIf(Pred pred) {
+  std::size_t erased = 0;
+  // Destinations that lose their last edge from the node being filtered
+  std::pmr::vector<NodeId> orphaned(GetResource());
+  for (auto srcNode : *nodeList_) {
+    if (nodes_[srcNode].GetEdges().Empty()) {
+      continue;
+    }
+    auto& src = nodes_.Mutable(srcNode);
+    auto& edges = src.edges_;
+    NodeId runDst = NO_NODE;
+    bool runKept = false;
+    edges.Filter([&](std::size_t i) {
+      auto dst = edges.Dst(i);
+      if (dst != runDst) {
+        if (runDst != NO_NODE && !runKept) {
+          orphaned.push_back(runDst);
+        }
+        runDst = dst;
+        runKept = false;
+      }
+      if (pred(src.GetValue(), nodes_[dst].GetValue(), edges.Weight(i))) {
+        fingerprint_ -= HashEdge(srcNode, dst, edges.Weight(i));
+        RemoveInEdges(dst, 1);
+        ++erased;
+        return false;
       }
+      runKept = true;
+      return true;
+    });
+    if (runDst != NO_NODE && !runKept) {
+      orphaned.push_back(runDst);
+    }
+    for (auto dst : orphaned) {
+      RemoveParent(dst, srcNode);
     }
+    orphaned.clear();
   }
-
-  return *this;
+  return erased;
 }
 
+// const_iterator
+
 /**
- * Pre-decrement Operator overload for const_reverse_iterator
+ * Pre-increment Operator overload for const_iterator
+ * Moves to the next edge, then the next node with outgoing edges. Everything
+ * is walked in place, so no allocation is done and a full scan touches each
+ * edge once.
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_reverse_iterator& gdwg::Graph<N, E>::const_reverse_iterator::
-operator--() {
-  std::vector<N> children;
-  for (const auto& child : (*node_iter_)->GetChildren()) {
-    auto child_lock = child.lock();
-    children.push_back(child_lock->GetValue());
+typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator++() {
+  ++edge_;
+  if (edge_ != node_->GetEdges().Size()) {
+    return *this;
   }
-  std::map<N, std::vector<E>> edge_map = (*node_iter_)->GetEdges();
-  std::vector<E> weights = edge_map[*edge_iter_];
-
-  if (weight_iter_ == weights.rbegin()) {
-    if (edge_iter_ == children.rbegin()) {
-      do {
-        --node_iter_;
-      } while (node_iter_ != reverse_sentinel_ && children.begin() == children.end());
 
-      if (children.begin() != children.end()) {
-        children = (*node_iter_)->GetChildren();
-        edge_map = (*node_iter_)->GetEdges();
+  // find the next node that has children
+  const auto& nodes = graph_->nodes_;
+  do {
+    ++node_iter_;
+  } while (node_iter_ != node_sentinel_ && nodes[*node_iter_].GetEdges().Empty());
 
-        edge_iter_ = children.rend();
-        --edge_iter_;
-
-        weight_iter_ = edge_map[*edge_iter_].rend();
-        --weight_iter_;
+  node_ = node_iter_ == node_sentinel_ ? nullptr : &nodes[*node_iter_];
+  edge_ = 0;
+  return *this;
+}
 
-      } else if (node_iter_ == reverse_sentinel_) {
-        throw std::runtime_error("Cannot cannot decrement past begin().");
+/**
+ * Pre-decrement Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator--() {
+  const auto& nodes = graph_->nodes_;
+  if (node_iter_ == node_sentinel_ || edge_ == 0) {
+    // find the previous node that has children
+    do {
+      if (node_iter_ == reverse_sentinel_) {
+        throw std::runtime_error("Cannot decrement past begin().");
       }
-
-    } else {
-      --edge_iter_;
-
-      weight_iter_ = edge_map[*edge_iter_].rend();
-      --weight_iter_;
-    }
-
-  } else {
-    --weight_iter_;
+      --node_iter_;
+    } while (nodes[*node_iter_].GetEdges().Empty());
+    node_ = &nodes[*node_iter_];
+    edge_ = node_->GetEdges().Size();
   }
 
+  --edge_;
   return *this;
 }
 
 /**
- * Post-increment Operator overload for const_reverse_iterator
+ * Post-increment Operator overload for const_iterator
  */
 template <typename N, typename E>
-const typename gdwg::Graph<N, E>::const_reverse_iterator gdwg::Graph<N, E>::const_reverse_iterator::
+const typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::const_iterator::
 operator++(int) {
   auto copy{*this};
-  --(*this);
+  ++(*this);
   return copy;
 }
 
 /**
- * Post-decrement Operator overload for const_reverse_iterator
+ * Post-decrement Operator overload for const_iterator
  */
 template <typename N, typename E>
-const typename gdwg::Graph<N, E>::const_reverse_iterator gdwg::Graph<N, E>::const_reverse_iterator::
+const typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::const_iterator::
 operator--(int) {
   auto copy{*this};
-  ++(*this);
+  --(*this);
   return copy;
 }
 
 /**
- * * Operator overload for const_reverse_iterator
+ * * Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator::reference gdwg::Graph<N, E>::const_iterator::
+operator*() const {
+  const auto& nodes = graph_->nodes_;
+  const auto& edges = node_->GetEdges();
+  return {node_->GetValue(), nodes[edges.Dst(edge_)].GetValue(), edges.Weight(edge_)};
+}
+
+/**
+ * Returns a const_iterator pointing to the first in the container. A
+ * const_iterator is an iterator that points to const content. This iterator
+ * can be increased and decreased (unless it is itself also const), but it
+ * cannot be used to modify the contents it points to, even if the content it
+ * points to is not itself const.
+ */
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
+  // find a node that has children
+  auto it = nodeList_->begin();
+  while (it != nodeList_->end() && nodes_[*it].GetEdges().Empty()) {
+    ++it;
+  }
+
+  return {this, it, nodeList_->end(), nodeList_->begin(), 0};
+}
+
+/**
+ * Returns a const_iterator pointing to the past-the-end element in the
+ * container. A const_iterator is an iterator that points to const content.
+ * This iterator can be increased and decreased (unless it is itself also
+ * const), but it cannot be used to modify the contents it points to, even if
+ * the content it points to is not itself const.
+ * If the container is empty, this function returns the same as
+ * vector::cbegin. The value returned shall not be dereferenced.
  */
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_reverse_iterator::reference
-    gdwg::Graph<N, E>::const_reverse_iterator::operator*() const {
-  return {(*node_iter_).GetValue(), *edge_iter_, *weight_iter_};
+typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cend() const {
+  return {this, nodeList_->end(), nodeList_->end(), nodeList_->begin(), 0};
 }
 
+// const_reverse_iterator
+
 /**
  * Returns a const_reverse_iterator pointing to the last element in the
  * container. A const_reverse_iterator is a reverse iterator that points to
@@ -1087,25 +2220,7 @@ typename gdwg::Graph<N, E>::const_reverse_iterator::reference
  */
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_reverse_iterator gdwg::Graph<N, E>::crbegin() const {
-  typename std::vector<std::shared_ptr<Node>>::iterator it = nodeList_.rbegin();
-
-  while (*it->GetChildren().size() == 0) {
-    ++it;
-  }
-
-  if (it == nodeList_.rend()) {
-    return rend();
-  }
-
-  std::vector<N> children;
-  for (const auto& child : (*it)->GetChildren()) {
-    auto child_lock = child.lock();
-    children.push_back(child_lock->GetValue());
-  }
-  std::map<N, std::vector<E>> edges = (*it).GetEdges();
-  std::vector<E> last_weights = edges.rbegin()->second;
-
-  return {it, nodeList_.rend(), nodeList_.end(), children.rbegin(), last_weights.rbegin()};
+  return const_reverse_iterator{cend()};
 }
 
 /**
@@ -1120,15 +2235,5 @@ typename gdwg::Graph<N, E>::const_reverse_iterator gdwg::Graph<N, E>::crbegin()
  */
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_reverse_iterator gdwg::Graph<N, E>::crend() const {
-  if (nodeList_.size() == 0) {
-    // todo
-    return reverse_iterator(end());
-  }
-
-  return {
-      nodeList_.rend(),
-      nodeList_.rend(),
-      nodeList_.end(),
-      {},
-  };
+  return const_reverse_iterator{cbegin()};
 }
@@ -0,0 +1,656 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ *
+ * Timings for the graph operations that matter on large graphs. Build with
+ * optimisations on, e.g. bazel run -c opt //assignments/dg:graph_benchmark
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/edge_list_reader.h"
+#include "assignments/dg/frozen_graph.h"
+#include "assignments/dg/frozen_graph.tpp"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph.tpp"
+#include "assignments/dg/mapped_graph.h"
+#include "assignments/dg/mapped_graph.tpp"
+
+// Looks long long nodes up by binary search, to compare against the dense index
+template <>
+struct gdwg::dense_node_ids<long long> : std::false_type {};
+
+namespace {
+
+/**
+ * Runs f once and returns how long it took in milliseconds
+ */
+template <typename F>
+double timeMs(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/**
+ * Graph of edgeCount edges spread over edgeCount / 8 nodes, so each node has
+ * about 8 outgoing edges to scattered destinations
+ */
+gdwg::Graph<int, int> makeGraph(int edgeCount) {
+  gdwg::Graph<int, int> g;
+  int nodeCount = edgeCount / 8;
+  for (int i = 0; i < nodeCount; ++i) {
+    g.InsertNode(i);
+  }
+  for (int i = 0; i < edgeCount; ++i) {
+    g.InsertEdge(i % nodeCount, static_cast<int>(i / 2 * 7919LL % nodeCount), i);
+  }
+  return g;
+}
+
+/**
+ * A full `for (auto [s, d, w] : g)` scan should cost the same per edge no
+ * matter how large the graph is
+ */
+void benchmarkScan() {
+  std::cout << "== full edge scan ==\n";
+  for (int edgeCount : {10000, 100000, 1000000}) {
+    auto g = makeGraph(edgeCount);
+    long long sum = 0;
+    int edges = 0;
+    double ms = timeMs([&] {
+      for (const auto& [src, dst, w] : g) {
+        sum += src + dst + w;
+        ++edges;
+      }
+    });
+    std::cout << "E = " << edges << ": " << ms << " ms, " << ms * 1e6 / edges
+              << " ns/edge (checksum " << sum << ")\n";
+  }
+}
+
+/**
+ * Loading a graph from tuples should be O(E log E), and skip the sort when
+ * the input is already sorted
+ */
+void benchmarkBulkLoad() {
+  std::cout << "== bulk load ==\n";
+  for (int edgeCount : {10000, 100000, 1000000}) {
+    int nodeCount = edgeCount / 8;
+    std::vector<std::tuple<int, int, int>> edges;
+    edges.reserve(edgeCount);
+    for (int i = 0; i < edgeCount; ++i) {
+      edges.emplace_back(i % nodeCount, static_cast<int>(i / 2 * 7919LL % nodeCount), i);
+    }
+
+    std::size_t loaded = 0;
+    double unsortedMs = timeMs([&] {
+      gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+      loaded += g.GetNodes().size();
+    });
+    std::sort(edges.begin(), edges.end());
+    double sortedMs = timeMs([&] {
+      gdwg::Graph<int, int> g{gdwg::sorted_unique, edges.cbegin(), edges.cend()};
+      loaded += g.GetNodes().size();
+    });
+    std::cout << "E = " << edgeCount << ": " << unsortedMs << " ms, sorted_unique " << sortedMs
+              << " ms (nodes " << loaded << ")\n";
+  }
+}
+
+/**
+ * Applying edges in batches should cost about the same per edge as loading
+ * them all at once
+ */
+void benchmarkBatches() {
+  std::cout << "== batched inserts ==\n";
+  int edgeCount = 1000000;
+  int nodeCount = edgeCount / 8;
+  std::vector<int> nodes;
+  for (int i = 0; i < nodeCount; ++i) {
+    nodes.push_back(i);
+  }
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < edgeCount; ++i) {
+    edges.emplace_back(i % nodeCount, static_cast<int>(i / 2 * 7919LL % nodeCount), i);
+  }
+
+  for (int batchSize : {10000, 100000, 1000000}) {
+    gdwg::Graph<int, int> g{nodes.cbegin(), nodes.cend()};
+    double ms = timeMs([&] {
+      for (auto batch = edges.cbegin(); batch != edges.cend(); batch += batchSize) {
+        g.InsertEdges(batch, batch + batchSize);
+      }
+    });
+    std::cout << "batch = " << batchSize << ": " << ms << " ms, " << ms * 1e6 / edgeCount
+              << " ns/edge\n";
+  }
+}
+
+/**
+ * Deleting the leaves around a hub should cost the same per leaf however many
+ * leaves the hub has, while the graph also churns through new nodes
+ */
+void benchmarkDeleteNode() {
+  std::cout << "== delete the leaves of a hub ==\n";
+  for (int leaves : {10000, 100000}) {
+    gdwg::Graph<int, int> g{0};
+    for (int i = 1; i <= leaves; ++i) {
+      g.InsertNode(i);
+      g.InsertEdge(i, 0, i);
+      g.InsertEdge(0, i, i);
+    }
+    double ms = timeMs([&] {
+      // Scattered order, and each deleted leaf's slot is taken by a new node
+      for (int i = 0; i < leaves; ++i) {
+        g.DeleteNode(static_cast<int>(i * 7919LL % leaves) + 1);
+        g.InsertNode(-i - 1);
+        g.InsertEdge(-i - 1, 0, i);
+      }
+    });
+    std::cout << "leaves = " << leaves << ": " << ms << " ms, " << ms * 1e6 / leaves
+              << " ns/leaf (edges " << std::distance(g.begin(), g.end()) << ")\n";
+  }
+}
+
+/**
+ * Merging two hubs should take time in their degrees, as should renaming one
+ */
+void benchmarkMergeHubs() {
+  std::cout << "== merge hubs, 100000 edges each way ==\n";
+  int degree = 100000;
+  // Hubs -1 and -2 have edges to and from overlapping halves of the leaves
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < degree; ++i) {
+    edges.emplace_back(-1, i, i % 4);
+    edges.emplace_back(i, -1, i % 4);
+    edges.emplace_back(-2, i + degree / 2, i % 4);
+    edges.emplace_back(i + degree / 2, -2, i % 4);
+  }
+  gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+  auto merged = g;
+  double mergeMs = timeMs([&] { merged.MergeReplace(-1, -2); });
+  auto renamed = g;
+  double replaceMs = timeMs([&] { renamed.Replace(-1, 3 * degree); });
+  std::cout << "MergeReplace: " << mergeMs << " ms, Replace: " << replaceMs << " ms (edges "
+            << std::distance(merged.begin(), merged.end()) << ")\n";
+}
+
+/**
+ * Pruning edges during a scan should cost about the same per edge as the
+ * scan. Erasing by iterator shifts the rest of the node's edges, so for a hub
+ * EraseEdgesIf, which filters each node once, is the way to prune.
+ */
+void benchmarkPrune() {
+  std::cout << "== prune every other edge ==\n";
+  auto spread = makeGraph(1000000);
+  std::vector<std::tuple<int, int, int>> hubEdges;
+  for (int i = 0; i < 100000; ++i) {
+    hubEdges.emplace_back(0, i, i);
+  }
+  gdwg::Graph<int, int> hub{hubEdges.cbegin(), hubEdges.cend()};
+  auto odd = [](int, int, int w) { return w % 2 == 1; };
+
+  for (auto [name, g] : {std::make_pair("E = 1000000 over 125000 nodes", &spread),
+                         std::make_pair("one node with 100000 edges", &hub)}) {
+    auto byIterator = *g;
+    auto edges = std::distance(g->begin(), g->end());
+    double iteratorMs = timeMs([&] {
+      for (auto it = byIterator.begin(); it != byIterator.end();) {
+        it = std::get<2>(*it) % 2 == 1 ? byIterator.erase(it) : std::next(it);
+      }
+    });
+    auto byPredicate = *g;
+    double predicateMs = timeMs([&] { byPredicate.EraseEdgesIf(odd); });
+    std::cout << name << ": erase(it) " << iteratorMs * 1e6 / edges << " ns/edge, EraseEdgesIf "
+              << predicateMs * 1e6 / edges << " ns/edge (same "
+              << (byIterator == byPredicate) << ")\n";
+  }
+}
+
+/**
+ * Copying a graph shares its storage, so a copy costs O(1) and each write to
+ * it copies about one page of nodes. Copying into another memory resource is
+ * one pass over the nodes and edges, and both are compared with rebuilding
+ * the graph one InsertNode and InsertEdge at a time.
+ */
+void benchmarkCopy() {
+  std::cout << "== copy, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  int nodeCount = 1000000 / 8;
+  std::size_t nodes = 0;
+  double rebuildMs = timeMs([&] {
+    gdwg::Graph<int, int> copy;
+    for (auto node : g.GetNodes()) {
+      copy.InsertNode(node);
+    }
+    for (const auto& [src, dst, w] : g) {
+      copy.InsertEdge(src, dst, w);
+    }
+    nodes += copy.GetNodes().size();
+  });
+  std::pmr::unsynchronized_pool_resource pool;
+  double deepMs = timeMs([&] {
+    gdwg::Graph<int, int> copy{&pool};
+    copy = g;
+    nodes += copy.GetNodes().size();
+  });
+  gdwg::Graph<int, int> copy;
+  double shareMs = timeMs([&] { copy = g; });
+  double writeMs = timeMs([&] {
+    for (int i = 0; i < 100; ++i) {
+      copy.InsertEdge(i * 997 % nodeCount, i, -i);
+    }
+  });
+  std::cout << "rebuilt: " << rebuildMs << " ms, into another resource: " << deepMs
+            << " ms, shared: " << shareMs << " ms, then 100 edges: " << writeMs << " ms (nodes "
+            << nodes << ")\n";
+}
+
+/**
+ * Comparing equal graphs is one pass over both, while graphs with different
+ * fingerprints and graphs sharing their storage are compared in O(1)
+ */
+void benchmarkEquality() {
+  std::cout << "== equality, E = 1000000 ==\n";
+  auto g1 = makeGraph(1000000);
+  auto g2 = makeGraph(1000000);
+  auto shared = g1;
+  bool equal = false;
+  bool differs = false;
+  bool same = false;
+  double equalMs = timeMs([&] { equal = g1 == g2; });
+  g2.InsertEdge(0, 1, -1);
+  double differentMs = timeMs([&] { differs = g1 != g2; });
+  double sharedMs = timeMs([&] { same = g1 == shared; });
+  std::cout << "equal: " << equalMs << " ms, different fingerprints: " << differentMs
+            << " ms, shared: " << sharedMs << " ms (" << equal << differs << same << ")\n";
+}
+
+/**
+ * Dumping a graph as text goes through one buffer and std::to_chars. The
+ * token by token path is what operator<< falls back to for streams with their
+ * own formatting, which a precision of 7 triggers without changing the text
+ * of int weights.
+ */
+void benchmarkDump() {
+  std::cout << "== text dump to /dev/null, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  std::ofstream stream{"/dev/null"};
+  double streamMs = timeMs([&] { stream << g; });
+  stream.precision(7);
+  double tokenMs = timeMs([&] { stream << g; });
+  std::FILE* file = std::fopen("/dev/null", "w");
+  bool ok = true;
+  double fileMs = timeMs([&] { ok = g.Dump(file) && ok; });
+  double fdMs = timeMs([&] { ok = g.Dump(fileno(file)) && ok; });
+  std::fclose(file);
+  std::cout << "token by token: " << tokenMs << " ms, operator<<: " << streamMs
+            << " ms, FILE*: " << fileMs << " ms, fd: " << fdMs << " ms (" << ok << ")\n";
+}
+
+/**
+ * Saving and loading should run at the speed of copying the file, and
+ * loading should be much cheaper than rebuilding from sorted edges
+ */
+void benchmarkSaveLoad() {
+  std::cout << "== binary save and load, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  std::string path = std::filesystem::temp_directory_path() / "graph_benchmark.gdwg";
+  double saveMs = timeMs([&] { g.Save(path); });
+  std::size_t nodes = 0;
+  double loadMs = timeMs([&] { nodes += gdwg::Graph<int, int>::Load(path).GetNodes().size(); });
+  double arenaMs = timeMs([&] {
+    std::pmr::monotonic_buffer_resource arena;
+    nodes += gdwg::Graph<int, int>::Load(path, &arena).GetNodes().size();
+  });
+  double mb = std::filesystem::file_size(path) / 1e6;
+
+  // The same bytes copied through a FILE*, with nothing done to them
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  double readMs = timeMs([&] {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    nodes += std::fread(bytes.data(), 1, bytes.size(), file) > 0;
+    std::fclose(file);
+  });
+  double writeMs = timeMs([&] {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    nodes += std::fwrite(bytes.data(), 1, bytes.size(), file) > 0;
+    std::fclose(file);
+  });
+  std::filesystem::remove(path);
+
+  std::vector<std::tuple<int, int, int>> edges{g.begin(), g.end()};
+  double rebuildMs = timeMs([&] {
+    gdwg::Graph<int, int> rebuilt{gdwg::sorted_unique, edges.cbegin(), edges.cend()};
+    nodes += rebuilt.GetNodes().size();
+  });
+  std::cout << mb << " MB, save: " << saveMs << " ms (" << mb / saveMs * 1000
+            << " MB/s), load: " << loadMs << " ms (" << mb / loadMs * 1000
+            << " MB/s), into an arena: " << arenaMs << " ms\nraw write: " << writeMs
+            << " ms, raw read: " << readMs << " ms, rebuilt from sorted edges: " << rebuildMs
+            << " ms (nodes " << nodes << ")\n";
+}
+
+/**
+ * Opening a mapped graph reads only its header, so it should take the same
+ * time however large the file is, and queries on it should cost about what
+ * they cost on a FrozenGraph
+ */
+void benchmarkMapped() {
+  std::cout << "== mapped graph, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  int nodeCount = 1000000 / 8;
+  std::string path = std::filesystem::temp_directory_path() / "graph_benchmark_mapped.gdwg";
+  g.Save(path);
+  std::size_t nodes = 0;
+  double loadMs = timeMs([&] { nodes += gdwg::Graph<int, int>::Load(path).GetNodes().size(); });
+  gdwg::MappedGraph<int, int> mapped;
+  double openMs = timeMs([&] { mapped = gdwg::MappedGraph<int, int>{path}; });
+  auto frozen = g.Freeze();
+  auto queries = [&](const auto& graph) {
+    int connected = 0;
+    double ms = timeMs([&] {
+      for (int i = 0; i < 1000000; ++i) {
+        connected += graph.IsConnected(i % nodeCount, static_cast<int>(i * 7919LL % nodeCount));
+      }
+    });
+    nodes += connected;
+    return ms;
+  };
+  double frozenMs = queries(frozen);
+  double mappedMs = queries(mapped);
+  bool verified = false;
+  double verifyMs = timeMs([&] { verified = mapped.Verify(); });
+  std::filesystem::remove(path);
+  std::cout << "open: " << openMs << " ms, Load: " << loadMs << " ms, verify: " << verifyMs
+            << " ms (" << verified << ")\n1M IsConnected, mapped: " << mappedMs
+            << " ms, frozen: " << frozenMs << " ms (" << nodes << ")\n";
+}
+
+/**
+ * Reading an edge list should be limited by parsing rather than by inserting,
+ * and parsing should scale with threads (up to the cores there are)
+ */
+void benchmarkEdgeListReader() {
+  std::cout << "== edge list text, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  std::string path = std::filesystem::temp_directory_path() / "graph_benchmark_edges.txt";
+  std::string text;
+  {
+    std::ostringstream os;
+    for (const auto& [src, dst, w] : g) {
+      os << src << '\t' << dst << '\t' << w << '\n';
+    }
+    text = os.str();
+    std::ofstream{path} << text;
+  }
+  double mb = text.size() / 1e6;
+
+  std::size_t nodes = 0;
+  double streamMs = timeMs([&] {
+    std::ifstream in{path};
+    gdwg::Graph<int, int> read;
+    int src, dst, w;
+    while (in >> src >> dst >> w) {
+      read.InsertNode(src);
+      read.InsertNode(dst);
+      read.InsertEdge(src, dst, w);
+    }
+    nodes += read.GetNodes().size();
+  });
+  std::vector<std::tuple<int, int, int>> parsed;
+  double parseMs = timeMs([&] { gdwg::parseEdgeLines<int, int>(text, '\t', parsed); });
+  std::cout << mb << " MB, >> and InsertEdge: " << streamMs << " ms (" << mb / streamMs * 1000
+            << " MB/s), parseEdgeLines alone: " << parseMs << " ms (" << mb / parseMs * 1000
+            << " MB/s)\n";
+  for (unsigned threads : {1u, 2u, 4u}) {
+    double readMs = timeMs([&] {
+      nodes += gdwg::readEdgeList<int, int>(path, {0, threads}).GetNodes().size();
+    });
+    std::cout << "readEdgeList on " << threads << " threads: " << readMs << " ms ("
+              << mb / readMs * 1000 << " MB/s)\n";
+  }
+  std::filesystem::remove(path);
+  std::cout << "(nodes " << nodes + parsed.size() << ")\n";
+}
+
+/**
+ * Times IsConnected over the edges of a graph whose nodes are 0..nodeCount - 1
+ */
+template <typename N>
+double lookupNs(int nodeCount, int lookups) {
+  gdwg::Graph<N, int> g;
+  for (int i = 0; i < nodeCount; ++i) {
+    g.InsertNode(i);
+  }
+  for (int i = 0; i < nodeCount * 8; ++i) {
+    g.InsertEdge(i % nodeCount, static_cast<N>(i / 2 * 7919LL % nodeCount), i);
+  }
+  int connected = 0;
+  double ms = timeMs([&] {
+    for (int i = 0; i < lookups; ++i) {
+      connected += g.IsConnected(static_cast<N>(i * 104729LL % nodeCount), i % nodeCount);
+    }
+  });
+  return connected > 0 ? ms * 1e6 / lookups : 0;
+}
+
+/**
+ * Looking up one weighted edge should cost two binary searches, with or
+ * without building an iterator to it
+ */
+void benchmarkFindEdge() {
+  std::cout << "== weighted edge lookups, E = 1000000 ==\n";
+  auto g = makeGraph(1000000);
+  std::vector<std::tuple<int, int, int>> edges{g.begin(), g.end()};
+  int lookups = 1000000;
+  int found = 0;
+  double findMs = timeMs([&] {
+    for (int i = 0; i < lookups; ++i) {
+      const auto& [src, dst, w] = edges[i * 7919LL % edges.size()];
+      found += g.find(src, dst, w + i % 2) != g.end();
+    }
+  });
+  double containsMs = timeMs([&] {
+    for (int i = 0; i < lookups; ++i) {
+      const auto& [src, dst, w] = edges[i * 7919LL % edges.size()];
+      found += g.ContainsEdge(src, dst, w + i % 2);
+    }
+  });
+  double weightsMs = timeMs([&] {
+    for (int i = 0; i < lookups; ++i) {
+      const auto& [src, dst, w] = edges[i * 7919LL % edges.size()];
+      auto weights = g.GetWeights(src, dst);
+      found += std::find(weights.begin(), weights.end(), w + i % 2) != weights.end();
+    }
+  });
+  std::cout << "find: " << findMs * 1e6 / lookups << " ns, ContainsEdge: "
+            << containsMs * 1e6 / lookups << " ns, GetWeights and std::find: "
+            << weightsMs * 1e6 / lookups << " ns (found " << found << ")\n";
+}
+
+/**
+ * Integral nodes should be found by indexing an array instead of by binary
+ * search, so lookups shouldn't slow down as the graph grows
+ */
+void benchmarkDenseLookups() {
+  std::cout << "== integral node lookups ==\n";
+  for (int nodeCount : {1000, 100000, 1000000}) {
+    std::cout << "V = " << nodeCount << ": dense " << lookupNs<int>(nodeCount, 1000000)
+              << " ns/lookup, searched " << lookupNs<long long>(nodeCount, 1000000)
+              << " ns/lookup\n";
+  }
+}
+
+// A weight that isn't trivially copyable, so it is stored next to its edge
+struct BoxedWeight {
+  int value;
+
+  BoxedWeight(int v) : value{v} {}  // NOLINT(runtime/explicit)
+  BoxedWeight(const BoxedWeight& other) : value{other.value} {}
+  BoxedWeight& operator=(const BoxedWeight& other) {
+    value = other.value;
+    return *this;
+  }
+
+  friend bool operator<(const BoxedWeight& w1, const BoxedWeight& w2) {
+    return w1.value < w2.value;
+  }
+  friend bool operator==(const BoxedWeight& w1, const BoxedWeight& w2) {
+    return w1.value == w2.value;
+  }
+};
+
+int weightValue(int w) {
+  return w;
+}
+
+int weightValue(const BoxedWeight& w) {
+  return w.value;
+}
+
+/**
+ * Times copying out and summing the weights of edgeCount parallel edges
+ */
+template <typename W>
+void weightScan(const char* name, int edgeCount) {
+  gdwg::Graph<int, W> g{0, 1};
+  std::vector<std::tuple<int, int, W>> edges;
+  for (int i = 0; i < edgeCount; ++i) {
+    edges.emplace_back(0, 1, W{i});
+  }
+  g.InsertEdges(edges.cbegin(), edges.cend());
+
+  std::size_t copied = 0;
+  double copyMs = timeMs([&] { copied += g.GetWeights(0, 1).size(); });
+  long long sum = 0;
+  double sumMs = timeMs([&] {
+    for (const auto& w : g.GetWeightsView(0, 1)) {
+      sum += weightValue(w);
+    }
+  });
+  std::cout << name << ": GetWeights " << copyMs * 1e6 / edgeCount << " ns/edge, sum "
+            << sumMs * 1e6 / edgeCount << " ns/edge (checksum " << sum + copied << ")\n";
+}
+
+/**
+ * Weight queries on a hub should cost the edges returned, not the hub's
+ * degree, once its weight order is sorted
+ */
+void benchmarkWeightQueries() {
+  std::cout << "== weight queries on a node with 100000 edges ==\n";
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < 100000; ++i) {
+    edges.emplace_back(0, i, static_cast<int>(i * 7919LL % 1000000));
+  }
+  gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+  int queries = 10000;
+  std::size_t found = 0;
+  double sortMs = timeMs([&] { found += g.GetLightestEdges(0, 1).size(); });
+  double rangeMs = timeMs([&] {
+    for (int i = 0; i < queries; ++i) {
+      found += g.GetEdgesByWeight(0, i * 97, i * 97 + 100).size();
+    }
+  });
+  double lightestMs = timeMs([&] {
+    for (int i = 0; i < queries; ++i) {
+      found += g.GetLightestEdges(0, 10).size();
+    }
+  });
+  // Without the index, each query scans every edge
+  double scanMs = timeMs([&] {
+    for (int i = 0; i < queries / 100; ++i) {
+      for (const auto& [src, dst, w] : g) {
+        found += src == 0 && dst >= 0 && w >= i * 97 && w < i * 97 + 100;
+      }
+    }
+  });
+  std::cout << "first query " << sortMs << " ms, then [lo, hi) " << rangeMs * 1e3 / queries
+            << " us, lightest 10 " << lightestMs * 1e3 / queries << " us, full scan "
+            << scanMs * 1e3 / (queries / 100) << " us (found " << found << ")\n";
+}
+
+/**
+ * Ranking every node by degree should read one count per node rather than
+ * gathering each node's neighbours and their weights
+ */
+void benchmarkDegrees() {
+  std::cout << "== rank nodes by degree, V = 100000, E = 1000000 ==\n";
+  int nodes = 100000;
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < 1000000; ++i) {
+    // Low numbered nodes are hubs, and a few edges are parallel
+    auto src = static_cast<int>(static_cast<long long>(i) * i % 1000003 % nodes);
+    auto dst = static_cast<int>(i * 7919LL % nodes) / (1 + i % 4);
+    edges.emplace_back(src, dst, i % 3);
+  }
+  gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+  auto values = g.GetNodes();
+  std::vector<std::pair<std::size_t, int>> ranked;
+  double countMs = timeMs([&] {
+    ranked.clear();
+    for (auto node : values) {
+      ranked.emplace_back(g.OutDegree(node) + g.InDegree(node), node);
+    }
+    std::sort(ranked.begin(), ranked.end(), std::greater<>{});
+  });
+  std::size_t top = ranked.front().first;
+  // What a caller did before, for the out-degree alone
+  double gatherMs = timeMs([&] {
+    ranked.clear();
+    for (auto node : values) {
+      std::size_t degree = 0;
+      for (auto dst : g.GetConnected(node)) {
+        degree += g.GetWeights(node, dst).size();
+      }
+      ranked.emplace_back(degree, node);
+    }
+    std::sort(ranked.begin(), ranked.end(), std::greater<>{});
+  });
+  std::cout << "counts " << countMs << " ms, GetConnected and GetWeights " << gatherMs
+            << " ms (top degree " << top << ", edges " << g.EdgeCount() << ")\n";
+}
+
+/**
+ * Trivially copyable weights live in a column of their own, so copying or
+ * scanning a run of them is a pass over one array
+ */
+void benchmarkWeightScan() {
+  std::cout << "== weight scans, E = 1000000 ==\n";
+  weightScan<int>("int column", 1000000);
+  weightScan<BoxedWeight>("boxed, with edges", 1000000);
+}
+
+}  // namespace
+
+int main() {
+  benchmarkScan();
+  benchmarkBulkLoad();
+  benchmarkBatches();
+  benchmarkDeleteNode();
+  benchmarkMergeHubs();
+  benchmarkPrune();
+  benchmarkCopy();
+  benchmarkEquality();
+  benchmarkDump();
+  benchmarkSaveLoad();
+  benchmarkMapped();
+  benchmarkEdgeListReader();
+  benchmarkFindEdge();
+  benchmarkDenseLookups();
+  benchmarkWeightScan();
+  benchmarkWeightQueries();
+  benchmarkDegrees();
+}
@@ -0,0 +1,247 @@
+/*
+Copyright [2019] Clive Chen, Vaishnavi Bapat
+zid - z5166040, z5075858
+
+  == Explanation and rational of testing ==
+
+ These tests check that a Graph given a memory resource keeps all of its
+ storage in that resource. This binary swaps the default memory resource for
+ one that counts what it allocates, which is why it is separate from
+ graph_test.cpp. Node values are std::pmr::strings that are too long for the
+ small string optimisation, so they have to be allocated somewhere too.
+
+ The graph's resource is a monotonic buffer over a fixed array with no
+ upstream, wrapped in a resource that counts what passes through it. Storage
+ that falls back to the default resource instead, e.g. a pmr container made
+ without the graph's resource, is caught by the default resource's count, and
+ running out of the buffer throws. Plain std::vectors, which the bulk
+ constructors and batch operations borrow while they run and return their
+ results in, use the global heap and are not counted, so this shows that the
+ graph's own storage stays in its resource rather than that nothing at all
+ reaches the heap.
+
+ Copies of a graph share its storage until they are written to, which can
+ only be seen by counting what is allocated, so that is tested here too.
+*/
+
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph.tpp"
+#include "catch.h"
+
+namespace {
+
+// Forwards to another resource, counting the allocations
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingResource(std::pmr::memory_resource* upstream) : upstream_{upstream} {}
+
+  std::size_t allocations = 0;
+  std::size_t bytes = 0;
+
+ private:
+  std::pmr::memory_resource* upstream_;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    this->bytes += bytes;
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Makes resource the default while it is in scope
+class DefaultResource {
+ public:
+  explicit DefaultResource(std::pmr::memory_resource* resource)
+    : previous_{std::pmr::set_default_resource(resource)} {}
+
+  DefaultResource(const DefaultResource&) = delete;
+
+  DefaultResource& operator=(const DefaultResource&) = delete;
+
+  ~DefaultResource() { std::pmr::set_default_resource(previous_); }
+
+ private:
+  std::pmr::memory_resource* previous_;
+};
+
+using PmrGraph = gdwg::Graph<std::pmr::string, int>;
+
+std::pmr::string longName(const std::string& suffix) {
+  return std::pmr::string{"a node name too long for sso " + suffix};
+}
+
+}  // namespace
+
+SCENARIO("A graph allocates from its memory resource") {
+  GIVEN("a graph over a fixed buffer and node values made ahead of time") {
+    static std::byte buffer[1 << 18];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource()};
+    CountingResource counting{&arena};
+    std::vector<std::pmr::string> names;
+    for (int i = 0; i < 8; ++i) {
+      names.push_back(longName(std::to_string(i)));
+    }
+    auto renamed = longName("renamed");
+    std::vector<std::tuple<std::pmr::string, std::pmr::string, int>> tuples;
+    for (int i = 0; i < 8; ++i) {
+      tuples.emplace_back(names[i], names[(i + 2) % 8], i);
+      tuples.emplace_back(names[i], names[(i + 5) % 8], -i);
+    }
+    auto sortedTuples = tuples;
+    std::sort(sortedTuples.begin(), sortedTuples.end());
+
+    WHEN("the graph is built, modified, read and destroyed") {
+      CountingResource fallback{std::pmr::new_delete_resource()};
+      int edges = 0;
+      int connected = 0;
+      bool bulkEqual = false;
+      {
+        DefaultResource scope{&fallback};
+        PmrGraph g{&counting};
+        for (const auto& name : names) {
+          g.InsertNode(name);
+        }
+        for (int i = 0; i < 8; ++i) {
+          g.InsertEdge(names[i], names[(i + 1) % 8], i);
+          g.InsertEdge(names[i], names[(i + 3) % 8], i);
+          g.InsertEdge(names[i], names[i], i);
+        }
+        g.erase(names[0], names[1], 0);
+        g.Replace(names[2], renamed);
+        g.DeleteNode(names[3]);
+        g.InsertNode(names[3]);
+        g.MergeReplace(names[4], names[5]);
+        g.InsertNodes(names.cbegin(), names.cend());
+        g.InsertEdges(tuples.cbegin(), tuples.cend());
+        g.EraseEdges(tuples.cbegin(), tuples.cbegin() + 4);
+        g.EraseEdgesIf([](const auto&, const auto&, int w) { return w < -5; });
+        g.erase(g.find(names[6], names[6], 6));
+
+        PmrGraph bulk{tuples.cbegin(), tuples.cend(), &counting};
+        PmrGraph sorted{gdwg::sorted_unique, sortedTuples.cbegin(), sortedTuples.cend(),
+                        &counting};
+        bulkEqual = bulk == sorted;
+
+        for (auto it = g.begin(); it != g.end(); ++it) {
+          ++edges;
+        }
+        for (const auto& dst : g.GetConnectedView(names[0])) {
+          connected += !dst.empty();
+        }
+      }
+
+      THEN("nothing falls back to the default resource") {
+        CHECK(fallback.allocations == 0);
+        CHECK(counting.allocations > 0);
+        CHECK(edges == 26);
+        CHECK(connected == 1);
+        CHECK(bulkEqual);
+      }
+    }
+  }
+}
+
+SCENARIO("Copying and moving graphs with memory resources") {
+  GIVEN("a graph using a memory resource") {
+    std::pmr::monotonic_buffer_resource arena;
+    PmrGraph g{&arena};
+    g.InsertNode(longName("a"));
+    g.InsertNode(longName("b"));
+    g.InsertEdge(longName("a"), longName("b"), 1);
+
+    WHEN("it is copied") {
+      PmrGraph copy{g};
+
+      THEN("the copy uses the default resource") {
+        CHECK(copy.GetResource() == std::pmr::get_default_resource());
+        CHECK((copy == g));
+      }
+    }
+
+    WHEN("it is moved") {
+      PmrGraph moved{std::move(g)};
+
+      THEN("the moved graph keeps the resource") {
+        CHECK(moved.GetResource() == &arena);
+        CHECK(moved.IsConnected(longName("a"), longName("b")));
+      }
+    }
+
+    WHEN("it is move assigned to a graph with another resource") {
+      std::pmr::monotonic_buffer_resource other;
+      PmrGraph assigned{&other};
+      assigned = std::move(g);
+
+      THEN("the graph keeps its own resource and gets a copy of the edges") {
+        CHECK(assigned.GetResource() == &other);
+        CHECK(assigned.GetWeights(longName("a"), longName("b")) == std::vector<int>{1});
+      }
+    }
+  }
+}
+
+SCENARIO("Copies share storage until they are changed") {
+  GIVEN("a graph of 1000 nodes and a graph to copy it into, using the same resource") {
+    std::pmr::monotonic_buffer_resource arena;
+    CountingResource counting{&arena};
+    PmrGraph g{&counting};
+    for (int i = 0; i < 1000; ++i) {
+      g.InsertNode(longName(std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      g.InsertEdge(longName(std::to_string(i)), longName(std::to_string(i * 7 % 1000)), i);
+    }
+    std::size_t graphBytes = counting.bytes;
+    PmrGraph copy{&counting};
+
+    WHEN("the graph is copy assigned") {
+      std::size_t allocationsBefore = counting.allocations;
+      copy = g;
+
+      THEN("nothing is allocated") {
+        CHECK(counting.allocations == allocationsBefore);
+        CHECK((copy == g));
+      }
+
+      AND_WHEN("the copy is queried by weight") {
+        std::size_t allocationsBefore = counting.allocations;
+        auto lightest = copy.GetLightestEdges(longName("1"), 1);
+        std::size_t indexAllocations = counting.allocations - allocationsBefore;
+        auto inRange = g.GetEdgesByWeight(longName("1"), 0, 10);
+
+        THEN("only the weight index is allocated, and the graphs share it") {
+          CHECK(indexAllocations <= 1);
+          CHECK(counting.allocations - allocationsBefore == indexAllocations);
+          CHECK(lightest == inRange);
+          CHECK(lightest.size() == 1);
+        }
+      }
+
+      AND_WHEN("an edge is added to the copy") {
+        std::size_t bytesBefore = counting.bytes;
+        copy.InsertEdge(longName("1"), longName("2"), 5);
+
+        THEN("only a small part of the graph is copied") {
+          CHECK(counting.bytes - bytesBefore < graphBytes / 10);
+          CHECK(copy.IsConnected(longName("1"), longName("2")));
+          CHECK_FALSE(g.IsConnected(longName("1"), longName("2")));
+        }
+      }
+    }
+  }
+}
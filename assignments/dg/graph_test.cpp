@@ -23,8 +23,8 @@ zid - z5166040, z5075858
  Given that those are tested solidly, we go on to test the equality and
  inequality operators. The reasoning for this is that once we get further
  into testing, it is much easier to assess the overall state of the
- accessible nodes and edges than to check the weak_ptrs and which are
- lockable throughout an entire graph that we've modified whilst testing
+ accessible nodes and edges than to check the node handles and parent
+ lists throughout an entire graph that we've modified whilst testing
  methods. Instead, we choose to create the graph being tested, modify it and
  compare it to the expected graph.
 
@@ -35,13 +35,22 @@ zid - z5166040, z5075858
  operations / methods / constructors I have explored various cases, including
  edge cases. I am sure there are cases I have missed, as is always the case.
 
- Also note that we only test N = std::string, E = int, since these are standard
- templates and we only use standard containers. This means that the sorting
- and comparison operators are implemented as part of the standard library.
- We are therefore confident that the templates will apply for any standard
- library type.
+ Also note that we mostly test N = std::string, E = int, since these are
+ standard templates and we only use standard containers. This means that the
+ sorting and comparison operators are implemented as part of the standard
+ library. We are therefore confident that the templates will apply for any
+ standard library type. The exception is integral N, which is looked up
+ through an array rather than the sorted node list, so it gets its own tests
+ at the end.
 */
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+
 #include "assignments/dg/graph.h"
 #include "assignments/dg/graph.tpp"
 #include "catch.h"
@@ -77,6 +86,42 @@ SCENARIO("Vector iterator constructor") {
   }
 }
 
+SCENARIO("Tuple iterator constructor") {
+  WHEN("the tuple iterator constructor is used with unsorted, repeated edges") {
+    std::vector<std::tuple<std::string, std::string, int>> v{
+        {"c", "a", 2}, {"a", "b", 5}, {"c", "a", 1}, {"a", "b", 5}, {"b", "b", 3}, {"a", "c", 4}};
+    gdwg::Graph<std::string, int> g{v.cbegin(), v.cend()};
+
+    THEN("the result matches a graph built one edge at a time") {
+      gdwg::Graph<std::string, int> expected{"a", "b", "c"};
+      expected.InsertEdge("a", "b", 5);
+      expected.InsertEdge("a", "c", 4);
+      expected.InsertEdge("b", "b", 3);
+      expected.InsertEdge("c", "a", 2);
+      expected.InsertEdge("c", "a", 1);
+      CHECK((g == expected));
+      CHECK(g.GetWeights("c", "a") == std::vector<int>{1, 2});
+    }
+
+    THEN("nodes know their parents") {
+      g.DeleteNode("c");
+      CHECK(g.GetConnected("a") == std::vector<std::string>{"b"});
+    }
+  }
+
+  WHEN("sorted, unique edges are loaded with the sorted_unique hint") {
+    std::vector<std::tuple<std::string, std::string, int>> v{
+        {"a", "b", 5}, {"a", "c", 4}, {"b", "b", 3}, {"c", "a", 1}, {"c", "a", 2}};
+    gdwg::Graph<std::string, int> g{gdwg::sorted_unique, v.cbegin(), v.cend()};
+
+    THEN("the result is the same as without the hint") {
+      CHECK((g == gdwg::Graph<std::string, int>{v.cbegin(), v.cend()}));
+      std::vector<std::tuple<std::string, std::string, int>> res{g.begin(), g.end()};
+      CHECK(res == v);
+    }
+  }
+}
+
 /***************************/
 /**  == Node Insertion == **/
 /***************************/
@@ -259,6 +304,88 @@ SCENARIO("Insert edge with non-existent dst") {
   }
 }
 
+/**************************/
+/**  == Batch Updates == **/
+/**************************/
+
+SCENARIO("Insert a batch of nodes") {
+  GIVEN("a graph with some nodes") {
+    gdwg::Graph<std::string, int> g{"b", "d"};
+
+    WHEN("a batch with new, existing and repeated nodes is inserted") {
+      std::vector<std::string> batch{"e", "b", "a", "e", "c"};
+      auto res = g.InsertNodes(batch.cbegin(), batch.cend());
+
+      THEN("each node is reported as if inserted one at a time") {
+        CHECK(res == std::vector<bool>{true, false, true, false, true});
+        CHECK(g.GetNodes() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+      }
+    }
+  }
+}
+
+SCENARIO("Insert a batch of edges") {
+  GIVEN("a graph with an edge") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "c", 1);
+
+    WHEN("a batch with new, existing and repeated edges is inserted") {
+      std::vector<std::tuple<std::string, std::string, int>> batch{
+          {"b", "a", 2}, {"a", "c", 1}, {"a", "b", 3}, {"a", "c", 0}, {"a", "b", 3}, {"c", "c", 4}};
+      auto res = g.InsertEdges(batch.cbegin(), batch.cend());
+
+      THEN("the edges are merged as if inserted one at a time") {
+        CHECK(res == std::vector<bool>{true, false, true, true, false, true});
+        gdwg::Graph<std::string, int> expected{"a", "b", "c"};
+        for (const auto& [src, dst, w] : batch) {
+          expected.InsertEdge(src, dst, w);
+        }
+        CHECK(g == expected);
+        CHECK(g.GetWeights("a", "c") == std::vector<int>{0, 1});
+      }
+
+      THEN("the new edges are removed when their destination is deleted") {
+        g.DeleteNode("b");
+        CHECK(g.GetConnected("a") == std::vector<std::string>{"c"});
+      }
+    }
+
+    WHEN("a batch refers to a non-existent node") {
+      std::vector<std::tuple<std::string, std::string, int>> batch{{"a", "b", 2}, {"a", "x", 3}};
+
+      THEN("an exception is thrown and no edge is added") {
+        CHECK_THROWS_WITH(g.InsertEdges(batch.cbegin(), batch.cend()),
+                          "Cannot call Graph::InsertEdges when either src or dst"
+                          " node does not exist");
+        CHECK_FALSE(g.IsConnected("a", "b"));
+      }
+    }
+  }
+}
+
+SCENARIO("Erase a batch of edges") {
+  GIVEN("a graph with several edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("a", "c", 3);
+    g.InsertEdge("c", "a", 4);
+
+    WHEN("a batch with existing, missing and repeated edges is erased") {
+      std::vector<std::tuple<std::string, std::string, int>> batch{
+          {"c", "a", 4}, {"a", "b", 2}, {"a", "b", 5}, {"x", "a", 1}, {"c", "a", 4}};
+      auto res = g.EraseEdges(batch.cbegin(), batch.cend());
+
+      THEN("only the existing edges are removed, once each") {
+        CHECK(res == std::vector<bool>{true, true, false, false, false});
+        CHECK(g.GetWeights("a", "b") == std::vector<int>{1});
+        CHECK(g.GetConnected("c").empty());
+        CHECK(g.IsConnected("a", "c"));
+      }
+    }
+  }
+}
+
 /*********************/
 /**  == Equality == **/
 /*********************/
@@ -433,6 +560,202 @@ SCENARIO("Evaluate the inequality of two graphs") {
   }
 }
 
+SCENARIO("Fingerprints follow the nodes and edges of a graph") {
+  GIVEN("a graph changed in every way, and a graph built from its final nodes and edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("b", "a", 3);
+    g.InsertEdge("c", "c", 4);
+    std::vector<std::tuple<std::string, std::string, int>> batch{
+        {"d", "a", 5}, {"a", "d", 6}, {"c", "a", 7}, {"b", "c", 8}};
+    g.InsertEdges(batch.cbegin(), batch.cend());
+    std::vector<std::tuple<std::string, std::string, int>> removed{{"a", "d", 6}};
+    g.EraseEdges(removed.cbegin(), removed.cend());
+    g.erase("a", "b", 2);
+    g.Replace("c", "e");
+    g.MergeReplace("d", "b");
+    g.InsertNode("f");
+    g.DeleteNode("a");
+
+    std::vector<std::tuple<std::string, std::string, int>> edges;
+    for (const auto& [src, dst, w] : g) {
+      edges.emplace_back(src, dst, w);
+    }
+    gdwg::Graph<std::string, int> expected{edges.cbegin(), edges.cend()};
+    expected.InsertNode("f");
+
+    THEN("both have the same fingerprint") {
+      CHECK(g == expected);
+      CHECK(g.GetFingerprint() == expected.GetFingerprint());
+      CHECK(g.GetFingerprint() != 0);
+    }
+
+    WHEN("an edge is added and then erased") {
+      auto before = g.GetFingerprint();
+      g.InsertEdge("f", "e", 9);
+
+      THEN("the fingerprint changes and then changes back") {
+        CHECK(g.GetFingerprint() != before);
+        CHECK_FALSE(g == expected);
+        g.erase("f", "e", 9);
+        CHECK(g.GetFingerprint() == before);
+      }
+    }
+
+    WHEN("an edge is reversed") {
+      CHECK(g.erase("b", "e", 8));
+      g.InsertEdge("e", "b", 8);
+      gdwg::Graph<std::string, int> reversed{g};
+
+      THEN("the graphs are told apart") {
+        CHECK(g.GetFingerprint() != expected.GetFingerprint());
+        CHECK_FALSE(reversed == expected);
+        CHECK(reversed == g);
+      }
+    }
+
+    WHEN("the graph is cleared") {
+      g.Clear();
+
+      THEN("it has the fingerprint of an empty graph") {
+        CHECK(g.GetFingerprint() == gdwg::Graph<std::string, int>{}.GetFingerprint());
+      }
+    }
+  }
+}
+
+/********************/
+/**  == Copying == **/
+/********************/
+
+SCENARIO("Copy a graph that has had nodes deleted") {
+  GIVEN("a graph whose nodes were deleted and re-inserted") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "a", 3);
+    g.InsertEdge("d", "d", 4);
+    g.DeleteNode("a");
+    g.InsertNode("e");
+    g.InsertEdge("e", "b", 5);
+    g.InsertEdge("b", "e", 6);
+
+    WHEN("it is copy constructed") {
+      gdwg::Graph<std::string, int> copy{g};
+
+      THEN("the copy has the same nodes and edges") {
+        CHECK(copy == g);
+        CHECK(copy.GetConnected("b") == std::vector<std::string>{"c", "e"});
+      }
+
+      THEN("deleting a node from the copy removes the edges to it") {
+        copy.DeleteNode("b");
+        CHECK(copy.GetConnected("e").empty());
+        CHECK(g.GetConnected("e") == std::vector<std::string>{"b"});
+      }
+    }
+
+    WHEN("it is copy assigned over a graph with other nodes") {
+      gdwg::Graph<std::string, int> copy{"x", "y"};
+      copy.InsertEdge("x", "y", 7);
+      copy = g;
+
+      THEN("only g's nodes and edges are left") {
+        CHECK(copy == g);
+        CHECK_FALSE(copy.IsNode("x"));
+      }
+
+      THEN("the copy can be changed without changing g") {
+        copy.Replace("e", "f");
+        copy.InsertEdge("f", "d", 8);
+        CHECK(copy.GetConnected("b") == std::vector<std::string>{"c", "f"});
+        CHECK(g.GetConnected("b") == std::vector<std::string>{"c", "e"});
+        CHECK_FALSE(g.IsNode("f"));
+      }
+    }
+  }
+}
+
+SCENARIO("Changing a copy or the graph it was copied from") {
+  GIVEN("a graph and a copy of it") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "c", 3);
+    gdwg::Graph<std::string, int> original{g};
+    gdwg::Graph<std::string, int> copy{g};
+
+    WHEN("the copy is changed in every way") {
+      copy.InsertNode("d");
+      copy.InsertEdge("d", "a", 4);
+      copy.erase("a", "b", 1);
+      copy.Replace("b", "e");
+      copy.MergeReplace("c", "a");
+      copy.DeleteNode("d");
+
+      THEN("the graph it was copied from is unchanged") {
+        CHECK(g == original);
+        CHECK(copy.GetNodes() == std::vector<std::string>{"a", "e"});
+        CHECK(copy.GetConnected("e") == std::vector<std::string>{"a"});
+        CHECK(copy.GetWeights("a", "a") == std::vector<int>{3});
+      }
+    }
+
+    WHEN("the graph it was copied from is changed and cleared") {
+      g.DeleteNode("b");
+      g.Clear();
+      g.InsertNode("z");
+
+      THEN("the copy is unchanged") {
+        CHECK(copy == original);
+        CHECK(copy.GetConnected("b") == std::vector<std::string>{"c"});
+      }
+    }
+  }
+
+  GIVEN("two copies of a graph that has been cleared") {
+    constexpr int n = 2000;
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < n; ++i) {
+      g.InsertNode(i);
+      g.InsertEdge(i, i / 2, i);
+    }
+    const gdwg::Graph<int, int> original{g};
+    std::vector<gdwg::Graph<int, int>> copies{g, g};
+    g.Clear();
+
+    WHEN("each copy is changed in its own thread") {
+      // Both threads start together, so they copy and write pages at once
+      std::atomic<int> ready{0};
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&copies, &ready, t] {
+          ++ready;
+          while (ready < 2) {
+          }
+          for (int i = 0; i < n; ++i) {
+            copies[t].InsertEdge(i, (i + t + 1) % n, -i - 1);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      THEN("each copy sees only its own changes") {
+        for (int t = 0; t < 2; ++t) {
+          CHECK(copies[t].EdgeCount() == 2 * n);
+          CHECK(copies[t].GetWeights(0, t + 1) == std::vector<int>{-1});
+          CHECK(copies[t].GetWeights(0, 2 - t).empty());
+          copies[t].EraseEdgesIf([](int, int, int w) { return w < 0; });
+          CHECK(copies[t] == original);
+        }
+      }
+    }
+  }
+}
+
 /***********************/
 /**  == DeleteNode == **/
 /***********************/
@@ -496,6 +819,80 @@ SCENARIO("Delete a node with children and parents") {
   }
 }
 
+SCENARIO("Delete nodes and add new ones in their place") {
+  GIVEN("a graph where every node is connected") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "a", 3);
+    g.InsertEdge("b", "b", 4);
+
+    WHEN("nodes are deleted and new ones inserted many times over") {
+      for (int i = 0; i < 10; ++i) {
+        g.DeleteNode("b");
+        g.InsertNode("b");
+        g.InsertNode("x" + std::to_string(i));
+        g.InsertEdge("x" + std::to_string(i), "b", i);
+        g.DeleteNode("x" + std::to_string(i));
+      }
+
+      THEN("none of the old edges come back") {
+        gdwg::Graph<std::string, int> expected{"a", "b", "c"};
+        expected.InsertEdge("c", "a", 3);
+        CHECK(g == expected);
+      }
+
+      THEN("the new node can be connected and deleted again") {
+        g.InsertEdge("a", "b", 5);
+        g.InsertEdge("b", "c", 6);
+        g.DeleteNode("c");
+        CHECK(g.GetConnected("a") == std::vector<std::string>{"b"});
+        CHECK(g.GetConnected("b").empty());
+      }
+    }
+  }
+}
+
+SCENARIO("Delete the neighbours of a hub in and out of order") {
+  GIVEN("a hub with edges to and from many leaves") {
+    gdwg::Graph<int, int> g{0};
+    for (int i = 1; i <= 100; ++i) {
+      g.InsertNode(i);
+      g.InsertEdge(i, 0, i);
+      g.InsertEdge(0, i, -i);
+    }
+
+    WHEN("every other leaf is deleted, from the middle outwards") {
+      for (int i = 50; i >= 1; i -= 2) {
+        g.DeleteNode(i);
+        g.DeleteNode(101 - i);
+      }
+
+      THEN("the hub only keeps its edges to and from the leaves left") {
+        gdwg::Graph<int, int> expected{0};
+        for (int i = 1; i <= 100; ++i) {
+          if ((i <= 50) == (i % 2 == 0)) {
+            continue;
+          }
+          expected.InsertNode(i);
+          expected.InsertEdge(i, 0, i);
+          expected.InsertEdge(0, i, -i);
+        }
+        CHECK(g == expected);
+        CHECK(gdwg::Graph<int, int>{g} == expected);
+      }
+
+      THEN("deleting the hub leaves every leaf on its own") {
+        g.DeleteNode(0);
+        for (auto node : g.GetNodes()) {
+          CHECK(g.GetConnected(node).empty());
+        }
+        CHECK(g.begin() == g.end());
+      }
+    }
+  }
+}
+
 SCENARIO("Delete a non-existent node") {
   GIVEN("a graph") {
     gdwg::Graph<std::string, int> g;
@@ -703,6 +1100,40 @@ SCENARIO("Replace a node with children and parents") {
   }
 }
 
+SCENARIO("Replace a node so it sorts before its siblings") {
+  GIVEN("a node with edges to several destinations") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("a", "d", 3);
+    g.InsertEdge("a", "d", 4);
+
+    WHEN("a destination is renamed past the others") {
+      g.Replace("d", "a0");
+
+      THEN("the edges stay sorted by destination then weight") {
+        CHECK(g.GetConnected("a") == std::vector<std::string>{"a0", "b", "c"});
+        CHECK(g.GetWeights("a", "a0") == std::vector<int>{3, 4});
+        std::vector<std::tuple<std::string, std::string, int>> res{g.begin(), g.end()};
+        std::vector<std::tuple<std::string, std::string, int>> expected{
+            {"a", "a0", 3}, {"a", "a0", 4}, {"a", "b", 1}, {"a", "c", 2}};
+        CHECK(res == expected);
+        CHECK(g.GetNodes() == std::vector<std::string>{"a", "a0", "b", "c"});
+      }
+    }
+
+    WHEN("the source is renamed past its destinations") {
+      g.Replace("a", "e");
+
+      THEN("the nodes stay sorted and the edges follow it") {
+        CHECK(g.GetNodes() == std::vector<std::string>{"b", "c", "d", "e"});
+        CHECK(g.GetConnected("e") == std::vector<std::string>{"b", "c", "d"});
+        CHECK(g.IsNode("a") == false);
+      }
+    }
+  }
+}
+
 SCENARIO("Replace a non-existent node") {
   GIVEN("a graph") {
     gdwg::Graph<std::string, int> g;
@@ -886,6 +1317,45 @@ SCENARIO("MergeReplace a node with itself") {
   }
 }
 
+SCENARIO("MergeReplace any pair of nodes in a dense graph") {
+  GIVEN("a graph with self edges and parallel edges everywhere") {
+    std::vector<std::tuple<int, int, int>> edges;
+    unsigned seed = 7;
+    for (int i = 0; i < 120; ++i) {
+      seed = seed * 1103515245 + 12345;
+      edges.emplace_back(seed % 6, seed / 7 % 6, seed / 49 % 4);
+    }
+    const gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+
+    THEN("merging each pair matches building the merged graph from scratch") {
+      for (int oldNode = 0; oldNode < 6; ++oldNode) {
+        for (int newNode = 0; newNode < 6; ++newNode) {
+          auto merged = g;
+          merged.MergeReplace(oldNode, newNode);
+
+          auto mapped = edges;
+          for (auto& [src, dst, w] : mapped) {
+            src = src == oldNode ? newNode : src;
+            dst = dst == oldNode ? newNode : dst;
+          }
+          gdwg::Graph<int, int> expected{mapped.cbegin(), mapped.cend()};
+          if (oldNode != newNode) {
+            expected.DeleteNode(oldNode);
+          }
+          CHECK(merged == expected);
+
+          // Every parent list is still right if deleting nodes agrees too
+          for (int n = 0; n < 6; ++n) {
+            merged.DeleteNode((n + newNode) % 6);
+            expected.DeleteNode((n + newNode) % 6);
+            CHECK(merged == expected);
+          }
+        }
+      }
+    }
+  }
+}
+
 /***************************/
 /**  == Printing Graph == **/
 /***************************/
@@ -995,6 +1465,59 @@ SCENARIO("Printing a disjointed graph") {
     }
   }
 }
+
+SCENARIO("Printing numbers as an ostream would") {
+  GIVEN("a graph of negative and large nodes with floating point weights") {
+    gdwg::Graph<long long, double> g{-3, 0, 9000000000};
+    std::vector<double> weights{0.1, 1.0 / 3, -2.5, 1e20, 123456789.0, 1e-7, 0.0};
+    for (auto w : weights) {
+      g.InsertEdge(-3, 9000000000, w);
+    }
+    g.InsertEdge(9000000000, 0, 7);
+
+    // The same text written token by token through an ostream
+    std::ostringstream tokens;
+    tokens << -3 << " (";
+    std::sort(weights.begin(), weights.end());
+    for (auto w : weights) {
+      tokens << "\n  " << 9000000000 << " | " << w;
+    }
+    tokens << "\n)\n" << 0 << " (\n)\n" << 9000000000 << " (\n  " << 0 << " | " << 7.0
+           << "\n)\n";
+
+    WHEN("it is printed") {
+      std::stringstream buffer;
+      buffer << g;
+
+      THEN("we get the same output") { CHECK(buffer.str() == tokens.str()); }
+    }
+
+    WHEN("it is dumped to a FILE* and to a file descriptor") {
+      std::FILE* file = std::tmpfile();
+      bool dumped = g.Dump(file) && std::fflush(file) == 0 && g.Dump(fileno(file));
+      std::rewind(file);
+      std::string text(2 * tokens.str().size(), '\0');
+      text.resize(std::fread(text.data(), 1, text.size(), file));
+      std::fclose(file);
+
+      THEN("we get the same output twice") {
+        CHECK(dumped);
+        CHECK(text == tokens.str() + tokens.str());
+      }
+    }
+
+    WHEN("it is printed to a stream with its own formatting") {
+      std::stringstream buffer;
+      buffer << std::fixed;
+      buffer.precision(2);
+      buffer << g;
+
+      THEN("the stream's formatting is used") {
+        CHECK(buffer.str().find("\n  9000000000 | 0.33\n") != std::string::npos);
+      }
+    }
+  }
+}
 /*********************/
 /**  == GetNodes == **/
 /*********************/
@@ -1075,6 +1598,32 @@ SCENARIO("Get nodes of graph where nodes have been deleted") {
   }
 }
 
+SCENARIO("Get nodes of a large graph built out of order") {
+  GIVEN("a graph whose nodes were inserted in a scrambled order") {
+    gdwg::Graph<int, int> g;
+    const int count = 5000;
+    for (int i = 0; i < count; ++i) {
+      // 7919 is prime, so this visits every value in [0, count) exactly once
+      g.InsertNode((i * 7919) % count);
+    }
+    for (int i = 0; i + 1 < count; ++i) {
+      g.InsertEdge(i, i + 1, i);
+    }
+
+    THEN("the nodes come out sorted and every lookup finds its node") {
+      auto nodeList = g.GetNodes();
+      CHECK(nodeList.size() == count);
+      CHECK(std::is_sorted(nodeList.begin(), nodeList.end()));
+      CHECK(g.IsNode(0));
+      CHECK(g.IsNode(count - 1));
+      CHECK_FALSE(g.IsNode(count));
+      CHECK(g.IsConnected(1234, 1235));
+      CHECK_FALSE(g.IsConnected(1235, 1234));
+      CHECK(g.GetWeights(1234, 1235) == std::vector<int>{1234});
+    }
+  }
+}
+
 /*************************/
 /**  == GetConnected == **/
 /*************************/
@@ -1293,3 +1842,810 @@ SCENARIO("Get weights of non-existent dst node") {
     }
   }
 }
+
+/*****************************************************/
+/**  == GetConnectedView and GetWeightsView ==      **/
+/*****************************************************/
+
+SCENARIO("Viewing the connections and weights of a node") {
+  GIVEN("a graph") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("c");
+    g.InsertNode("d");
+    g.InsertNode("b");
+    g.InsertNode("a");
+    g.InsertEdge("a", "b", 10);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "d", 4);
+    g.InsertEdge("a", "d", 50);
+    g.InsertEdge("b", "b", 2);
+
+    WHEN("taking views of the edges") {
+      const auto& cg = g;
+      auto connected = cg.GetConnectedView("a");
+      auto weights = cg.GetWeightsView("a", "d");
+      auto none = cg.GetWeightsView("a", "c");
+
+      THEN("they hold the same values as the copying getters") {
+        CHECK(std::vector<std::string>(connected.begin(), connected.end()) == g.GetConnected("a"));
+        CHECK(std::vector<int>(weights.begin(), weights.end()) == g.GetWeights("a", "d"));
+        CHECK(connected.size() == 2);
+        CHECK(weights[1] == 50);
+        CHECK(none.empty());
+        CHECK(cg.GetConnectedView("c").empty());
+      }
+
+      THEN("the views refer to the graph's own storage") {
+        CHECK(&*weights.begin() == &*cg.GetWeightsView("a", "d").begin());
+        CHECK(&*connected.begin() == &*cg.GetConnectedView("a").begin());
+      }
+    }
+
+    WHEN("a destination is deleted") {
+      g.DeleteNode("d");
+
+      THEN("it is no longer in the view") {
+        auto connected = g.GetConnectedView("a");
+        CHECK(std::vector<std::string>(connected.begin(), connected.end()) ==
+              std::vector<std::string>{"b"});
+      }
+    }
+
+    THEN("views of missing nodes throw like the copying getters") {
+      CHECK_THROWS_AS(g.GetConnectedView("x"), std::out_of_range);
+      CHECK_THROWS_AS(g.GetWeightsView("a", "x"), std::out_of_range);
+    }
+  }
+}
+
+/*********************************************************/
+/**  == GetEdgesByWeight and GetLightestEdges ==         **/
+/*********************************************************/
+
+// The out-edges of src with weight in [lo, hi) found by a full scan, in
+// order of weight then destination
+template <typename N, typename E>
+std::vector<std::pair<N, E>>
+edgesByWeight(const gdwg::Graph<N, E>& g, const N& src, const E& lo, const E& hi) {
+  std::vector<std::pair<N, E>> res;
+  for (const auto& [from, to, w] : g) {
+    if (from == src && !(w < lo) && w < hi) {
+      res.emplace_back(to, w);
+    }
+  }
+  std::sort(res.begin(), res.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.second, lhs.first) < std::tie(rhs.second, rhs.first);
+  });
+  return res;
+}
+
+SCENARIO("Querying edges by weight") {
+  GIVEN("a graph with many parallel edges and repeated weights") {
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i < 400; ++i) {
+      edges.emplace_back(i % 5, i * 7 % 23, i * 13 % 17);
+    }
+    gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+    auto matchesScan = [&g] {
+      for (auto src : g.GetNodes()) {
+        for (int lo = -7; lo < 19; lo += 4) {
+          for (int hi = lo; hi < 20; hi += 5) {
+            CHECK(g.GetEdgesByWeight(src, lo, hi) == edgesByWeight(g, src, lo, hi));
+          }
+        }
+        auto all = edgesByWeight(g, src, -100, 100);
+        for (std::size_t k : {0, 1, 5, 40, 1000}) {
+          std::vector<std::pair<int, int>> lightest{
+              all.begin(), all.begin() + static_cast<int>(std::min(k, all.size()))};
+          CHECK(g.GetLightestEdges(src, k) == lightest);
+        }
+      }
+    };
+
+    THEN("the queries match a scan of the edges") { matchesScan(); }
+
+    WHEN("the graph changes between queries") {
+      matchesScan();
+      g.InsertEdge(0, 3, -5);
+      g.erase(1, 7, 6);
+      g.Replace(22, -1);
+      g.MergeReplace(4, 2);
+      g.EraseEdgesIf([](int, int dst, int w) { return dst == 14 && w < 8; });
+      g.erase(g.find(3, 0, 0));
+
+      THEN("the queries see the changes") { matchesScan(); }
+
+      THEN("a copy gives the same answers") {
+        const auto copy = g;
+        g.InsertEdge(3, 3, 3);
+        for (auto src : g.GetNodes()) {
+          CHECK(copy.GetEdgesByWeight(src, 0, 10) == edgesByWeight(copy, src, 0, 10));
+        }
+        matchesScan();
+      }
+    }
+
+    THEN("missing nodes throw like the other getters") {
+      CHECK_THROWS_WITH(g.GetEdgesByWeight(99, 0, 1), "Cannot call Graph::GetEdgesByWeight if "
+                                                       "src doesn't exist in the graph");
+      CHECK_THROWS_WITH(g.GetLightestEdges(99, 1), "Cannot call Graph::GetLightestEdges if src "
+                                                   "doesn't exist in the graph");
+    }
+  }
+
+  GIVEN("copies that share a node's edges") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 2000; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < 2000; ++i) {
+      g.InsertEdge(0, i, i * 7919 % 2000);
+    }
+    const auto copy1 = g;
+    const auto copy2 = g;
+
+    THEN("each copy can be queried from its own thread") {
+      std::vector<std::pair<int, int>> lightest1;
+      std::vector<std::pair<int, int>> lightest2;
+      std::thread t1{[&] { lightest1 = copy1.GetLightestEdges(0, 5); }};
+      std::thread t2{[&] { lightest2 = copy2.GetLightestEdges(0, 5); }};
+      t1.join();
+      t2.join();
+      auto all = edgesByWeight(g, 0, -1, 2000);
+      std::vector<std::pair<int, int>> expected{all.begin(), all.begin() + 5};
+      CHECK(lightest1 == expected);
+      CHECK(lightest2 == expected);
+    }
+  }
+
+  GIVEN("weights that are kept with their destinations") {
+    gdwg::Graph<std::string, std::string> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", "pear");
+    g.InsertEdge("a", "c", "apple");
+    g.InsertEdge("a", "b", "fig");
+    g.InsertEdge("a", "a", "kiwi");
+
+    THEN("the queries order the weights the same way") {
+      CHECK(g.GetEdgesByWeight("a", std::string{"b"}, std::string{"l"}) ==
+            edgesByWeight(g, std::string{"a"}, std::string{"b"}, std::string{"l"}));
+      CHECK(g.GetLightestEdges("a", 2) ==
+            std::vector<std::pair<std::string, std::string>>{{"c", "apple"}, {"b", "fig"}});
+      g.erase("a", "c", "apple");
+      CHECK(g.GetLightestEdges("a", 1) ==
+            std::vector<std::pair<std::string, std::string>>{{"b", "fig"}});
+    }
+  }
+}
+
+/*****************************************/
+/**  == Degrees and Counts ==           **/
+/*****************************************/
+
+// Checks every count the graph keeps against a scan of its edges
+template <typename N, typename E>
+void checkCounts(const gdwg::Graph<N, E>& g) {
+  std::map<N, std::set<N>> children;
+  std::map<N, std::set<N>> parents;
+  std::map<N, std::size_t> outEdges;
+  std::map<N, std::size_t> inEdges;
+  std::size_t edgeCount = 0;
+  for (const auto& [src, dst, w] : g) {
+    children[src].insert(dst);
+    parents[dst].insert(src);
+    ++outEdges[src];
+    ++inEdges[dst];
+    ++edgeCount;
+  }
+  // GetNodes isn't const, but a copy shares the graph's storage
+  auto nodes = gdwg::Graph<N, E>{g}.GetNodes();
+  for (const auto& node : nodes) {
+    CHECK(g.OutDegree(node) == children[node].size());
+    CHECK(g.InDegree(node) == parents[node].size());
+    CHECK(g.OutEdgeCount(node) == outEdges[node]);
+    CHECK(g.InEdgeCount(node) == inEdges[node]);
+  }
+  CHECK(g.NodeCount() == nodes.size());
+  CHECK(g.EdgeCount() == edgeCount);
+}
+
+SCENARIO("Degrees and counts are kept in step with every change") {
+  GIVEN("an empty graph") {
+    gdwg::Graph<int, int> g;
+
+    THEN("everything counts zero") {
+      CHECK(g.NodeCount() == 0);
+      CHECK(g.EdgeCount() == 0);
+    }
+
+    THEN("degrees of missing nodes throw like the other getters") {
+      CHECK_THROWS_WITH(g.OutDegree(1), "Cannot call Graph::OutDegree if src doesn't exist in "
+                                        "the graph");
+      CHECK_THROWS_WITH(g.InDegree(1), "Cannot call Graph::InDegree if dst doesn't exist in the "
+                                       "graph");
+      CHECK_THROWS_WITH(g.OutEdgeCount(1), "Cannot call Graph::OutEdgeCount if src doesn't exist "
+                                           "in the graph");
+      CHECK_THROWS_WITH(g.InEdgeCount(1), "Cannot call Graph::InEdgeCount if dst doesn't exist in "
+                                          "the graph");
+    }
+  }
+
+  GIVEN("a hub with parallel and self edges") {
+    gdwg::Graph<int, int> g{0, 1, 2, 3};
+    g.InsertEdge(0, 1, 1);
+    g.InsertEdge(0, 1, 2);
+    g.InsertEdge(0, 2, 1);
+    g.InsertEdge(0, 0, 5);
+    g.InsertEdge(3, 0, 1);
+    g.InsertEdge(3, 0, 4);
+
+    THEN("degrees count neighbours once and edge counts count every edge") {
+      CHECK(g.NodeCount() == 4);
+      CHECK(g.EdgeCount() == 6);
+      CHECK(g.OutDegree(0) == 3);
+      CHECK(g.OutEdgeCount(0) == 4);
+      CHECK(g.InDegree(0) == 2);
+      CHECK(g.InEdgeCount(0) == 3);
+      CHECK(g.InDegree(1) == 1);
+      CHECK(g.InEdgeCount(1) == 2);
+      checkCounts(g);
+    }
+
+    WHEN("an edge that already exists is inserted again") {
+      g.InsertEdge(0, 1, 2);
+
+      THEN("nothing is counted twice") { checkCounts(g); }
+    }
+
+    WHEN("the hub is deleted") {
+      g.DeleteNode(0);
+
+      THEN("its neighbours lose their edges to and from it") {
+        CHECK(g.EdgeCount() == 0);
+        CHECK(g.OutDegree(3) == 0);
+        CHECK(g.InEdgeCount(1) == 0);
+        checkCounts(g);
+      }
+    }
+
+    WHEN("the hub is merged into a neighbour it shares edges with") {
+      g.InsertEdge(3, 1, 1);
+      g.InsertEdge(1, 2, 1);
+      g.MergeReplace(0, 1);
+
+      THEN("the merged edges are counted once") { checkCounts(g); }
+    }
+  }
+
+  GIVEN("a graph changed by every kind of operation") {
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i < 300; ++i) {
+      edges.emplace_back(i % 7, i * 5 % 13, i % 4);
+    }
+    gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+    checkCounts(g);
+
+    WHEN("edges are inserted and erased one at a time and in batches") {
+      g.InsertNode(20);
+      g.InsertEdge(20, 20, 1);
+      g.InsertEdge(20, 3, 1);
+      g.erase(0, 0, 0);
+      g.erase(g.find(1, 5, 1));
+      std::vector<std::tuple<int, int, int>> batch{{4, 20, 1}, {4, 20, 2}, {5, 6, 9}, {5, 6, 9}};
+      g.InsertEdges(batch.cbegin(), batch.cend());
+      batch = {{4, 20, 1}, {2, 10, 2}, {6, 4, 2}, {9, 9, 9}};
+      g.EraseEdges(batch.cbegin(), batch.cend());
+      g.EraseEdgesIf([](int src, int dst, int w) { return src == 3 && (dst < 6 || w == 2); });
+
+      THEN("the counts match a scan") { checkCounts(g); }
+    }
+
+    WHEN("nodes are replaced, merged and deleted") {
+      g.Replace(12, -1);
+      g.MergeReplace(3, 4);
+      g.MergeReplace(5, 5);
+      g.MergeReplace(0, 6);
+      g.DeleteNode(8);
+
+      THEN("the counts match a scan") { checkCounts(g); }
+    }
+
+    WHEN("the graph is copied, moved and cleared") {
+      std::pmr::monotonic_buffer_resource resource;
+      gdwg::Graph<int, int> shared{g};
+      gdwg::Graph<int, int> copied{&resource};
+      copied = g;
+      g.DeleteNode(1);
+      auto moved = std::move(shared);
+
+      THEN("each keeps its own counts") {
+        checkCounts(g);
+        checkCounts(copied);
+        checkCounts(moved);
+        CHECK(copied.EdgeCount() == moved.EdgeCount());
+        CHECK(copied.EdgeCount() > g.EdgeCount());
+        g.Clear();
+        CHECK(g.NodeCount() == 0);
+        CHECK(g.EdgeCount() == 0);
+      }
+    }
+
+    WHEN("the graph is saved and loaded") {
+      std::string path = std::filesystem::temp_directory_path() / "graph_test_counts.gdwg";
+      g.Save(path);
+      auto loaded = gdwg::Graph<int, int>::Load(path);
+      std::filesystem::remove(path);
+
+      THEN("the loaded graph has the same counts") {
+        checkCounts(loaded);
+        CHECK(loaded.EdgeCount() == g.EdgeCount());
+      }
+    }
+  }
+}
+/**********************/
+/**  == Iterators == **/
+/**********************/
+
+SCENARIO("Iterating over an empty graph") {
+  GIVEN("a graph with nodes but no edges") {
+    gdwg::Graph<std::string, int> g{"a", "b"};
+
+    THEN("begin is end") {
+      CHECK(g.begin() == g.end());
+      CHECK(g.rbegin() == g.rend());
+    }
+  }
+}
+
+SCENARIO("Iterating over the edges of a graph") {
+  GIVEN("a graph with isolated nodes between connected ones") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("c");
+    g.InsertNode("d");
+    g.InsertNode("b");
+    g.InsertNode("a");
+    g.InsertNode("e");
+    g.InsertEdge("a", "b", 10);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "d", 4);
+    g.InsertEdge("c", "b", 3);
+    g.InsertEdge("d", "d", 5);
+    std::vector<std::tuple<std::string, std::string, int>> expected{
+        {"a", "b", 1}, {"a", "b", 10}, {"a", "d", 4}, {"c", "b", 3}, {"d", "d", 5}};
+
+    THEN("a range for visits every edge in order") {
+      std::vector<std::tuple<std::string, std::string, int>> res;
+      for (const auto& [from, to, weight] : g) {
+        res.emplace_back(from, to, weight);
+      }
+      CHECK(res == expected);
+    }
+
+    THEN("decrementing from the end visits every edge backwards") {
+      std::vector<std::tuple<std::string, std::string, int>> res;
+      for (auto it = g.end(); it != g.begin();) {
+        --it;
+        res.emplace_back(*it);
+      }
+      std::reverse(expected.begin(), expected.end());
+      CHECK(res == expected);
+    }
+
+    THEN("the reverse iterators visit every edge backwards") {
+      std::vector<std::tuple<std::string, std::string, int>> res;
+      for (auto it = g.rbegin(); it != g.rend(); ++it) {
+        res.emplace_back(*it);
+      }
+      std::reverse(expected.begin(), expected.end());
+      CHECK(res == expected);
+    }
+
+    THEN("decrementing past the beginning throws") {
+      auto it = g.begin();
+      CHECK_THROWS_WITH(--it, "Cannot decrement past begin().");
+    }
+
+    WHEN("the graph is copied") {
+      gdwg::Graph<std::string, int> copy{g};
+
+      THEN("the copy has every node and edge") { CHECK(copy == g); }
+    }
+  }
+}
+
+SCENARIO("Finding edges") {
+  GIVEN("a graph with parallel edges and nodes without edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 10);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "d", 4);
+    g.InsertEdge("c", "b", 3);
+    g.InsertEdge("d", "d", 5);
+
+    THEN("finding an edge gives an iterator to it that carries on from there") {
+      auto it = g.find("a", "b", 10);
+      REQUIRE(it != g.end());
+      CHECK(*it == std::make_tuple("a", "b", 10));
+      CHECK(*++it == std::make_tuple("a", "d", 4));
+      CHECK(*++it == std::make_tuple("c", "b", 3));
+      CHECK(*--(--it) == std::make_tuple("a", "b", 10));
+      CHECK(std::next(g.find("d", "d", 5)) == g.end());
+      CHECK(g.find("a", "b", 1) == g.begin());
+    }
+
+    THEN("edges that aren't there give the end") {
+      CHECK(g.find("a", "b", 2) == g.end());
+      CHECK(g.find("a", "c", 1) == g.end());
+      CHECK(g.find("b", "a", 10) == g.end());
+      CHECK(g.find("z", "b", 10) == g.end());
+      CHECK(g.find("a", "z", 10) == g.end());
+    }
+
+    THEN("ContainsEdge agrees with find") {
+      CHECK(g.ContainsEdge("a", "b", 1));
+      CHECK(g.ContainsEdge("d", "d", 5));
+      CHECK(g.ContainsEdge("a", "b", 2) == false);
+      CHECK(g.ContainsEdge("e", "a", 1) == false);
+      CHECK(g.ContainsEdge("z", "a", 1) == false);
+      CHECK(g.ContainsEdge("a", "z", 1) == false);
+    }
+
+    WHEN("a node is renamed so the nodes are no longer in the order they were added") {
+      g.Replace("a", "f");
+
+      THEN("found iterators still carry on in order") {
+        CHECK(*std::next(g.find("f", "b", 10)) == std::make_tuple("f", "d", 4));
+        CHECK(*std::next(g.find("c", "b", 3)) == std::make_tuple("d", "d", 5));
+        CHECK(*std::prev(g.find("f", "b", 1)) == std::make_tuple("d", "d", 5));
+      }
+    }
+  }
+
+  GIVEN("a larger graph of integers") {
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i < 500; ++i) {
+      edges.emplace_back(i % 37, i * 7 % 53, i % 5);
+    }
+    gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+
+    THEN("every edge is found where iteration reaches it, and no other weight is") {
+      for (auto it = g.begin(); it != g.end(); ++it) {
+        const auto& [src, dst, w] = *it;
+        CHECK(g.find(src, dst, w) == it);
+        CHECK(g.ContainsEdge(src, dst, w));
+        CHECK(g.find(src, dst, w + 5) == g.end());
+        CHECK(g.ContainsEdge(src, dst, w + 5) == false);
+      }
+    }
+  }
+}
+
+SCENARIO("Erasing edges while iterating") {
+  GIVEN("a graph with parallel edges, self edges and nodes without edges") {
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i < 300; ++i) {
+      edges.emplace_back(i % 13 * 2, i * 5 % 17 * 2, i % 4);
+    }
+    gdwg::Graph<int, int> g{edges.cbegin(), edges.cend()};
+    for (int n = 1; n < 34; n += 2) {
+      g.InsertNode(n);
+    }
+    auto prune = [](int src, int dst, int w) { return (src + dst + w) % 3 != 0; };
+
+    std::vector<std::tuple<int, int, int>> kept;
+    for (const auto& [src, dst, w] : g) {
+      if (!prune(src, dst, w)) {
+        kept.emplace_back(src, dst, w);
+      }
+    }
+    gdwg::Graph<int, int> expected{kept.cbegin(), kept.cend()};
+    for (int n = 1; n < 34; n += 2) {
+      expected.InsertNode(n);
+    }
+    for (auto node : g.GetNodes()) {
+      expected.InsertNode(node);
+    }
+
+    WHEN("edges are erased through the iterator as they are visited") {
+      auto copy = g;
+      std::vector<std::tuple<int, int, int>> visited;
+      for (auto it = g.begin(); it != g.end();) {
+        const auto& [src, dst, w] = *it;
+        visited.emplace_back(src, dst, w);
+        it = prune(src, dst, w) ? g.erase(it) : std::next(it);
+      }
+
+      THEN("every edge is visited once and only the kept ones are left") {
+        CHECK(visited == std::vector<std::tuple<int, int, int>>{copy.begin(), copy.end()});
+        CHECK(g == expected);
+        CHECK(copy != g);
+      }
+
+      THEN("nodes that lost all their edges can be deleted cleanly") {
+        for (auto node : g.GetNodes()) {
+          g.DeleteNode(node);
+          expected.DeleteNode(node);
+          CHECK(g == expected);
+        }
+      }
+    }
+
+    WHEN("the same edges are erased with EraseEdgesIf") {
+      auto total = std::distance(g.begin(), g.end());
+      auto erased = g.EraseEdgesIf(prune);
+
+      THEN("the graph is the same as pruning by iterator") {
+        CHECK(erased == total - kept.size());
+        CHECK(g == expected);
+        for (auto node : g.GetNodes()) {
+          g.DeleteNode(node);
+          expected.DeleteNode(node);
+          CHECK(g == expected);
+        }
+      }
+    }
+  }
+
+  GIVEN("a graph where a node's last edge is followed by nodes without edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("d", "a", 3);
+
+    THEN("erasing steps over them to the next edge, then to the end") {
+      auto it = g.erase(g.find("a", "b", 1));
+      CHECK(*it == std::make_tuple("a", "b", 2));
+      CHECK(g.IsConnected("a", "b"));
+      it = g.erase(it);
+      CHECK(*it == std::make_tuple("d", "a", 3));
+      CHECK(g.IsConnected("a", "b") == false);
+      CHECK(g.erase(it) == g.end());
+      CHECK(g.erase(g.end()) == g.end());
+      CHECK(g.begin() == g.end());
+      CHECK(g == gdwg::Graph<std::string, int>{"a", "b", "c", "d"});
+    }
+  }
+}
+
+/*****************************/
+/**  == Integral Nodes == **/
+/*****************************/
+
+SCENARIO("Looking up integral nodes spread in and out of the dense index") {
+  GIVEN("a graph of int nodes with negative, far off and nearly contiguous values") {
+    gdwg::Graph<int, int> g;
+    g.InsertNode(1000000);
+    g.InsertNode(-5);
+    g.InsertNode(500);
+    for (int i = 0; i < 300; ++i) {
+      g.InsertNode(i);
+    }
+    g.InsertEdge(500, 1000000, 1);
+    g.InsertEdge(-5, 3, 2);
+    g.InsertEdge(3, 500, 3);
+
+    THEN("every node is found, whether or not its value is indexed") {
+      CHECK(g.IsNode(1000000));
+      CHECK(g.IsNode(-5));
+      CHECK(g.IsNode(500));
+      CHECK(g.IsNode(299));
+      CHECK_FALSE(g.IsNode(300));
+      CHECK_FALSE(g.IsNode(-1));
+      CHECK(g.GetNodes().size() == 303);
+      CHECK(g.GetConnected(3) == std::vector<int>{500});
+      CHECK(g.IsConnected(500, 1000000));
+    }
+
+    WHEN("nodes are deleted, replaced and merged") {
+      g.DeleteNode(3);
+      g.Replace(500, 3);
+      g.Replace(-5, 2000000);
+      g.MergeReplace(0, 1);
+
+      THEN("lookups follow the new values") {
+        CHECK_FALSE(g.IsNode(500));
+        CHECK_FALSE(g.IsNode(-5));
+        CHECK_FALSE(g.IsNode(0));
+        CHECK(g.IsConnected(3, 1000000));
+        CHECK(g.GetConnected(2000000).empty());
+        CHECK(g.GetNodes().front() == 1);
+        CHECK(g.GetNodes().back() == 2000000);
+      }
+
+      THEN("a graph built from the same nodes and edges is equal") {
+        auto nodes = g.GetNodes();
+        gdwg::Graph<int, int> expected{nodes.cbegin(), nodes.cend()};
+        expected.InsertEdge(3, 1000000, 1);
+        CHECK(g == expected);
+      }
+
+      THEN("a copy finds the same nodes through its own index") {
+        gdwg::Graph<int, int> copy{g};
+        copy.InsertNode(0);
+        CHECK(copy.IsConnected(3, 1000000));
+        CHECK_FALSE(copy.IsNode(500));
+        CHECK(copy.IsNode(299));
+        CHECK(copy.IsNode(0));
+        CHECK_FALSE(g.IsNode(0));
+      }
+    }
+  }
+}
+
+/*****************************/
+/**  == Weight Storage == **/
+/*****************************/
+
+SCENARIO("Weights that are not trivially copyable are kept with their edges") {
+  GIVEN("a graph with string weights") {
+    gdwg::Graph<std::string, std::string> g{"a", "b", "c"};
+    std::vector<std::tuple<std::string, std::string, std::string>> edges{
+        {"a", "b", "a long weight that lives on the heap"}, {"a", "c", "y"}, {"a", "b", "x"},
+        {"c", "a", "z"}, {"a", "a", "w"}};
+    g.InsertEdges(edges.cbegin(), edges.cend());
+
+    WHEN("edges are erased, renamed and merged") {
+      std::vector<std::tuple<std::string, std::string, std::string>> removed{{"a", "c", "y"}};
+      g.EraseEdges(removed.cbegin(), removed.cend());
+      g.Replace("a", "d");
+      g.MergeReplace("c", "b");
+
+      THEN("the weights stay with their edges") {
+        std::vector<std::tuple<std::string, std::string, std::string>> expected{
+            {"b", "d", "z"},
+            {"d", "b", "a long weight that lives on the heap"},
+            {"d", "b", "x"},
+            {"d", "d", "w"}};
+        std::vector<std::tuple<std::string, std::string, std::string>> res{g.begin(), g.end()};
+        CHECK(res == expected);
+        auto weights = g.GetWeightsView("d", "b");
+        CHECK(std::vector<std::string>(weights.begin(), weights.end()) ==
+              g.GetWeights("d", "b"));
+      }
+    }
+  }
+}
+
+/*****************************/
+/**  == Saving and Loading == **/
+/*****************************/
+
+SCENARIO("Saving a graph and loading it back") {
+  GIVEN("a graph with deleted nodes, parallel edges and self edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "b", 5);
+    g.InsertEdge("d", "a", 3);
+    g.InsertEdge("e", "d", 4);
+    g.DeleteNode("c");
+    std::string path = std::filesystem::temp_directory_path() / "graph_test_save.gdwg";
+    g.Save(path);
+
+    WHEN("it is loaded") {
+      auto loaded = gdwg::Graph<std::string, int>::Load(path);
+
+      THEN("it equals the graph that was saved") {
+        CHECK(loaded == g);
+        CHECK(loaded.GetFingerprint() == g.GetFingerprint());
+        CHECK(loaded.GetConnected("a") == std::vector<std::string>{"b"});
+      }
+
+      THEN("it can be changed like the graph that was saved") {
+        g.DeleteNode("a");
+        loaded.DeleteNode("a");
+        g.MergeReplace("e", "b");
+        loaded.MergeReplace("e", "b");
+        CHECK(loaded == g);
+      }
+    }
+
+    WHEN("a byte of the file is changed") {
+      std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+      file.seekg(70);
+      char c = static_cast<char>(file.get() ^ 1);
+      file.seekp(70);
+      file.put(c);
+      file.close();
+
+      THEN("it can't be loaded") {
+        CHECK_THROWS_AS((gdwg::Graph<std::string, int>::Load(path)), std::runtime_error);
+      }
+    }
+
+    WHEN("the file is cut short") {
+      std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+      THEN("it can't be loaded") {
+        CHECK_THROWS_AS((gdwg::Graph<std::string, int>::Load(path)), std::runtime_error);
+      }
+    }
+
+    WHEN("it is loaded as a graph of another type") {
+      THEN("it can't be loaded") {
+        CHECK_THROWS_AS((gdwg::Graph<int, int>::Load(path)), std::runtime_error);
+        CHECK_THROWS_AS((gdwg::Graph<std::string, double>::Load(path)), std::runtime_error);
+      }
+    }
+  }
+
+  GIVEN("a graph of numbers, which are saved bitwise") {
+    gdwg::Graph<int, double> g{-4, 1, 3, 5000};
+    g.InsertEdge(-4, 5000, 0.5);
+    g.InsertEdge(-4, 5000, -1.25);
+    g.InsertEdge(5000, 1, 7);
+    g.InsertEdge(3, 3, 1e10);
+    std::string path = std::filesystem::temp_directory_path() / "graph_test_bitwise.gdwg";
+    g.Save(path);
+
+    WHEN("it is loaded") {
+      auto loaded = gdwg::Graph<int, double>::Load(path);
+
+      THEN("it equals the graph that was saved") {
+        CHECK(loaded == g);
+        CHECK(loaded.IsNode(5000));
+        CHECK(loaded.GetWeights(-4, 5000) == std::vector<double>{-1.25, 0.5});
+      }
+    }
+
+    WHEN("it is saved over and the new file can't be written") {
+      gdwg::Graph<int, double> other{7};
+      std::filesystem::create_directory(path + ".tmp");
+      CHECK_THROWS_WITH(other.Save(path), "Cannot call Graph::Save on a path that can't be "
+                                          "written");
+      std::filesystem::remove(path + ".tmp");
+
+      THEN("the file saved before is left as it was") {
+        CHECK(gdwg::Graph<int, double>::Load(path) == g);
+      }
+    }
+
+    WHEN("it is saved over") {
+      gdwg::Graph<int, double> other{7};
+      other.Save(path);
+
+      THEN("the file is replaced and no temporary file is left") {
+        CHECK(gdwg::Graph<int, double>::Load(path) == other);
+        CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+      }
+    }
+  }
+}
+
+// Stores a vector of ints as its length and then its elements
+template <>
+struct gdwg::Serializer<std::vector<int>> {
+  static constexpr bool BITWISE = false;
+
+  static void Write(BinaryWriter& out, const std::vector<int>& value) {
+    out.WriteValue(static_cast<std::uint32_t>(value.size()));
+    out.WriteBytes(value.data(), value.size() * sizeof(int));
+  }
+
+  static std::vector<int> Read(BinaryReader& in) {
+    std::vector<int> value(in.ReadValue<std::uint32_t>());
+    in.ReadBytes(value.data(), value.size() * sizeof(int));
+    return value;
+  }
+};
+
+SCENARIO("Saving weights with a serializer of their own") {
+  GIVEN("a graph weighted by vectors") {
+    gdwg::Graph<char, std::vector<int>> g{'x', 'y'};
+    g.InsertEdge('x', 'y', {1, 2, 3});
+    g.InsertEdge('x', 'y', {});
+    g.InsertEdge('y', 'y', {4});
+    std::string path = std::filesystem::temp_directory_path() / "graph_test_custom.gdwg";
+
+    WHEN("it is saved and loaded") {
+      g.Save(path);
+      auto loaded = gdwg::Graph<char, std::vector<int>>::Load(path);
+
+      THEN("the weights come back through the serializer") {
+        // Bracketed, since vector weights can't be printed
+        CHECK((loaded == g));
+        CHECK(loaded.GetWeights('x', 'y') == std::vector<std::vector<int>>{{}, {1, 2, 3}});
+      }
+    }
+  }
+}
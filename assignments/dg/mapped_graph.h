@@ -0,0 +1,176 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_MAPPED_GRAPH_H_
+#define ASSIGNMENTS_DG_MAPPED_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/view.h"
+
+namespace gdwg {
+
+/**
+ * Read-only graph that uses a file written by Graph::Save in place, through a
+ * shared read-only mapping of it. Opening one only reads the header, and
+ * nothing is copied out of the file after that, so every process mapping the
+ * same file shares its pages in the page cache. Queries answer as they would
+ * on the Graph that was saved, and ids and edge order are those of
+ * FrozenGraph.
+ *
+ * N and E must be stored bitwise (see Serializer). Opening checks the header
+ * and the edge offsets, but not the checksum or the destinations of edges,
+ * which would mean reading every edge. A destination changed in the file
+ * would be read as a node id unchecked, so using a graph mapped from an
+ * untrusted file is undefined behaviour until Verify() has returned true.
+ */
+template <typename N, typename E>
+class MappedGraph {
+ public:
+  using NodeId = std::uint32_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = std::tuple<N*, N*, E*>;
+    using difference_type = int;
+
+    reference operator*() const;
+
+    const_iterator& operator++();
+
+    const const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    const_iterator& operator--();
+
+    const const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.graph_ == rhs.graph_ && lhs.edge_ == rhs.edge_;
+    }
+
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class MappedGraph;
+
+    const MappedGraph* graph_;
+    // source node of edge_, kept in step with it so neither moves backwards
+    NodeId src_;
+    std::size_t edge_;
+
+    const_iterator(const MappedGraph* graph, NodeId src, std::size_t edge)
+      : graph_{graph}, src_{src}, edge_{edge} {}
+  };
+
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  // An empty graph, mapping nothing
+  MappedGraph() = default;
+
+  explicit MappedGraph(const std::string& path);
+
+  MappedGraph(const MappedGraph&) = delete;
+
+  MappedGraph& operator=(const MappedGraph&) = delete;
+
+  MappedGraph(MappedGraph&& other) noexcept { Swap(other); }
+
+  MappedGraph& operator=(MappedGraph&& other) noexcept {
+    Swap(other);
+    return *this;
+  }
+
+  ~MappedGraph();
+
+  // Reads the whole file, returns true if it matches its checksum
+  bool Verify() const;
+
+  bool IsNode(const N& val) const;
+
+  bool IsConnected(const N& src, const N& dst) const;
+
+  std::vector<N> GetNodes() const;
+
+  std::vector<N> GetConnected(const N& src) const;
+
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+
+  // Index based access for traversal algorithms
+
+  inline std::size_t NodeCount() const { return nodeCount_; }
+
+  inline std::size_t EdgeCount() const { return edgeCount_; }
+
+  NodeId GetId(const N& val) const;
+
+  inline const N& GetValue(NodeId id) const { return nodes_[id]; }
+
+  inline View<const NodeId*> GetOutDestinations(NodeId id) const {
+    return {dsts_ + offsets_[id], dsts_ + offsets_[id + 1]};
+  }
+
+  inline View<const E*> GetOutWeights(NodeId id) const {
+    return {weights_ + offsets_[id], weights_ + offsets_[id + 1]};
+  }
+
+  const_iterator cbegin() const;
+
+  const_iterator cend() const { return {this, static_cast<NodeId>(nodeCount_), edgeCount_}; }
+
+  const_reverse_iterator crbegin() const { return const_reverse_iterator{cend()}; }
+
+  const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
+
+  inline const_iterator begin() const { return cbegin(); }
+
+  inline const_iterator end() const { return cend(); }
+
+  inline const_reverse_iterator rbegin() const { return crbegin(); }
+
+  inline const_reverse_iterator rend() const { return crend(); }
+
+ private:
+  // Returns NodeCount() if val is not a node
+  NodeId FindId(const N& val) const;
+
+  // Range of src's out-edges going to dst, as positions in dsts_
+  std::pair<std::size_t, std::size_t> EdgeRange(NodeId src, NodeId dst) const;
+
+  void Swap(MappedGraph& other) noexcept;
+
+  // The mapping of the whole file
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  // The parts of the file, laid out as FrozenGraph lays out its vectors
+  const N* nodes_ = nullptr;
+  const std::uint64_t* offsets_ = nullptr;
+  const NodeId* dsts_ = nullptr;
+  const E* weights_ = nullptr;
+  std::size_t nodeCount_ = 0;
+  std::size_t edgeCount_ = 0;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_MAPPED_GRAPH_H_
@@ -0,0 +1,311 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+
+#include "assignments/dg/mapped_graph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "assignments/dg/serializer.h"
+
+/**
+ * Constructor
+ * Maps the file at path, written by Graph<N, E>::Save. The header is read to
+ * check the file is a saved graph of this type and that its parts fill the
+ * file exactly, and the edge offsets are checked to rise from 0 to the edge
+ * count, so every edge position used later is inside the file. This reads
+ * O(V) of the file and none of the edges. Throws std::runtime_error if the
+ * file can't be mapped or isn't a saved graph of this type.
+ *
+ * @param path - file written by Graph<N, E>::Save
+ */
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>::MappedGraph(const std::string& path) {
+  using Saved = Graph<N, E>;
+  static_assert(Saved::BITWISE_NODES && Saved::BITWISE_WEIGHTS,
+                "MappedGraph needs N and E to be stored bitwise");
+  static_assert(alignof(N) <= Saved::SAVE_ALIGNMENT && alignof(E) <= Saved::SAVE_ALIGNMENT);
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open a MappedGraph on a path that can't be read");
+  }
+  struct stat st;
+  typename Saved::SaveHeader header;
+  bool read = ::fstat(fd, &st) == 0 &&
+              ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+  // The counts are only read once the whole header has been
+  if (read) {
+    auto expected = Saved::MakeSaveHeader(header.nodes, header.edges);
+    read = std::memcmp(&header, &expected, sizeof(header)) == 0;
+  }
+  if (!read) {
+    ::close(fd);
+    throw std::runtime_error("Cannot open a MappedGraph on a file that isn't a saved graph of "
+                             "this type");
+  }
+
+  // Where each part starts, as Graph::Save pads them
+  auto padded = [](std::uint64_t size) {
+    return (size + Saved::SAVE_ALIGNMENT - 1) / Saved::SAVE_ALIGNMENT * Saved::SAVE_ALIGNMENT;
+  };
+  auto fileSize = static_cast<std::uint64_t>(st.st_size);
+  std::uint64_t nodesAt = padded(sizeof(header));
+  std::uint64_t offsetsAt = nodesAt + padded(header.nodes * sizeof(N));
+  std::uint64_t dstsAt = offsetsAt + padded((header.nodes + 1) * sizeof(std::uint64_t));
+  std::uint64_t weightsAt = dstsAt + padded(header.edges * sizeof(NodeId));
+  std::uint64_t checksumAt = weightsAt + padded(header.edges * sizeof(E));
+  // Counts bigger than the file could wrap the sums above
+  if (header.nodes >= fileSize || header.edges >= fileSize ||
+      checksumAt + sizeof(std::uint64_t) != fileSize) {
+    ::close(fd);
+    throw std::runtime_error("Cannot open a MappedGraph on a corrupt file");
+  }
+
+  void* data = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Cannot open a MappedGraph on a path that can't be mapped");
+  }
+  // Each node's edges are looked up through the offsets, so they must stay
+  // within the edges
+  auto offsets = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(data) + offsetsAt);
+  bool ordered = offsets[0] == 0 && offsets[header.nodes] == header.edges;
+  for (std::uint64_t i = 0; ordered && i < header.nodes; ++i) {
+    ordered = offsets[i] <= offsets[i + 1];
+  }
+  if (!ordered) {
+    ::munmap(data, fileSize);
+    throw std::runtime_error("Cannot open a MappedGraph on a corrupt file");
+  }
+  data_ = static_cast<const char*>(data);
+  size_ = fileSize;
+  nodes_ = reinterpret_cast<const N*>(data_ + nodesAt);
+  offsets_ = reinterpret_cast<const std::uint64_t*>(data_ + offsetsAt);
+  dsts_ = reinterpret_cast<const NodeId*>(data_ + dstsAt);
+  weights_ = reinterpret_cast<const E*>(data_ + weightsAt);
+  nodeCount_ = header.nodes;
+  edgeCount_ = header.edges;
+}
+
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>::~MappedGraph() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+template <typename N, typename E>
+void gdwg::MappedGraph<N, E>::Swap(MappedGraph& other) noexcept {
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  std::swap(nodes_, other.nodes_);
+  std::swap(offsets_, other.offsets_);
+  std::swap(dsts_, other.dsts_);
+  std::swap(weights_, other.weights_);
+  std::swap(nodeCount_, other.nodeCount_);
+  std::swap(edgeCount_, other.edgeCount_);
+}
+
+/**
+ * Returns true if the file matches the checksum Graph::Save wrote at its end.
+ * This reads every page of the file, so it takes as long as loading it.
+ */
+template <typename N, typename E>
+bool gdwg::MappedGraph<N, E>::Verify() const {
+  if (data_ == nullptr) {
+    return true;
+  }
+  Checksum checksum;
+  checksum.Update(data_, size_ - sizeof(std::uint64_t));
+  std::uint64_t sum;
+  std::memcpy(&sum, data_ + size_ - sizeof(sum), sizeof(sum));
+  return sum == checksum.Value();
+}
+
+/**
+ * Binary search for the id of val
+ *
+ * @param val - value of potential node
+ * @return the id of val, or NodeCount() if val is not a node
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::NodeId gdwg::MappedGraph<N, E>::FindId(const N& val) const {
+  auto it = std::lower_bound(nodes_, nodes_ + nodeCount_, val);
+  if (it == nodes_ + nodeCount_ || val < *it) {
+    return nodeCount_;
+  }
+  return it - nodes_;
+}
+
+/**
+ * Returns the positions [first, last) of the edges src → dst. Since the edges
+ * of a node are sorted by destination this is a binary search.
+ *
+ * @param src - id of source node
+ * @param dst - id of destination node
+ */
+template <typename N, typename E>
+std::pair<std::size_t, std::size_t> gdwg::MappedGraph<N, E>::EdgeRange(NodeId src,
+                                                                       NodeId dst) const {
+  auto range = std::equal_range(dsts_ + offsets_[src], dsts_ + offsets_[src + 1], dst);
+  return {range.first - dsts_, range.second - dsts_};
+}
+
+/**
+ * Returns the id of the node with value val. Ids are contiguous from 0 in
+ * increasing order of value.
+ *
+ * @param val - value of the node
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::NodeId gdwg::MappedGraph<N, E>::GetId(const N& val) const {
+  auto id = FindId(val);
+  if (id == nodeCount_) {
+    throw std::out_of_range("Cannot call MappedGraph::GetId if val doesn't exist in the graph");
+  }
+  return id;
+}
+
+/**
+ * Returns true if a node with value val exists in the graph and false
+ * otherwise.
+ *
+ * @param val - value of potential node
+ */
+template <typename N, typename E>
+bool gdwg::MappedGraph<N, E>::IsNode(const N& val) const {
+  return FindId(val) != nodeCount_;
+}
+
+/**
+ * Returns true if the edge src → dst exists in the graph and false otherwise.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ */
+template <typename N, typename E>
+bool gdwg::MappedGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto srcId = FindId(src);
+  auto dstId = FindId(dst);
+  if (srcId == nodeCount_ || dstId == nodeCount_) {
+    throw std::runtime_error("Cannot call MappedGraph::IsConnected if src or dst node don't "
+                             "exist in the graph");
+  }
+  auto range = EdgeRange(srcId, dstId);
+  return range.first != range.second;
+}
+
+/**
+ * Returns a vector of all nodes in the graph, sorted by increasing order of
+ * node.
+ */
+template <typename N, typename E>
+std::vector<N> gdwg::MappedGraph<N, E>::GetNodes() const {
+  return {nodes_, nodes_ + nodeCount_};
+}
+
+/**
+ * Returns a vector of the nodes connected to src by an outgoing edge, sorted
+ * by increasing order of node.
+ *
+ * @param src - source node
+ */
+template <typename N, typename E>
+std::vector<N> gdwg::MappedGraph<N, E>::GetConnected(const N& src) const {
+  auto srcId = FindId(src);
+  if (srcId == nodeCount_) {
+    throw std::out_of_range("Cannot call MappedGraph::GetConnected if src doesn't exist in the "
+                            "graph");
+  }
+
+  std::vector<N> res;
+  auto dsts = GetOutDestinations(srcId);
+  for (auto dst = dsts.begin(); dst != dsts.end(); ++dst) {
+    // Parallel edges share a destination, only report it once
+    if (dst == dsts.begin() || *dst != *(dst - 1)) {
+      res.push_back(nodes_[*dst]);
+    }
+  }
+  return res;
+}
+
+/**
+ * Returns a vector of the weights of edges src → dst, sorted by increasing
+ * order of edge.
+ *
+ * @param src - source node
+ * @param dst - destination node
+ */
+template <typename N, typename E>
+std::vector<E> gdwg::MappedGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto srcId = FindId(src);
+  auto dstId = FindId(dst);
+  if (srcId == nodeCount_ || dstId == nodeCount_) {
+    throw std::out_of_range("Cannot call MappedGraph::GetWeights if src or dst node don't exist"
+                            " in the graph");
+  }
+  auto range = EdgeRange(srcId, dstId);
+  return {weights_ + range.first, weights_ + range.second};
+}
+
+// const_iterator
+
+/**
+ * Returns a const_iterator pointing to the first edge of the graph, or cend()
+ * if the graph has no edges.
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::const_iterator gdwg::MappedGraph<N, E>::cbegin() const {
+  // Skip over the leading nodes without any outgoing edges
+  NodeId src = 0;
+  while (src < nodeCount_ && offsets_[src + 1] == 0) {
+    ++src;
+  }
+  return {this, src, 0};
+}
+
+/**
+ * Pre-increment Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::const_iterator& gdwg::MappedGraph<N, E>::const_iterator::
+operator++() {
+  ++edge_;
+  while (src_ < graph_->nodeCount_ && graph_->offsets_[src_ + 1] <= edge_) {
+    ++src_;
+  }
+  return *this;
+}
+
+/**
+ * Pre-decrement Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::const_iterator& gdwg::MappedGraph<N, E>::const_iterator::
+operator--() {
+  --edge_;
+  while (graph_->offsets_[src_] > edge_) {
+    --src_;
+  }
+  return *this;
+}
+
+/**
+ * * Operator overload for const_iterator
+ */
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::const_iterator::reference gdwg::MappedGraph<N, E>::
+const_iterator::operator*() const {
+  return {graph_->nodes_[src_], graph_->nodes_[graph_->dsts_[edge_]], graph_->weights_[edge_]};
+}
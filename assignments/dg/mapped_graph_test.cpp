@@ -0,0 +1,206 @@
+/*
+Copyright [2019] Clive Chen, Vaishnavi Bapat
+zid - z5166040, z5075858
+
+  == Explanation and rational of testing ==
+
+ A MappedGraph is only ever opened on a file saved from a Graph, so each test
+ builds a Graph with the public Graph API (which is tested in graph_test.cpp),
+ saves it and checks that the mapped file answers queries the same way the
+ Graph does. Nodes are chars since only bitwise types can be mapped. Files
+ that aren't saved graphs of the right type, or whose edge offsets point
+ outside the edges, have to be turned away when they are opened, and damage
+ anywhere else has to be caught by Verify.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph.tpp"
+#include "assignments/dg/mapped_graph.h"
+#include "assignments/dg/mapped_graph.tpp"
+#include "catch.h"
+
+namespace {
+
+gdwg::Graph<char, int> makeGraph() {
+  gdwg::Graph<char, int> g;
+  g.InsertNode('c');
+  g.InsertNode('d');
+  g.InsertNode('b');
+  g.InsertNode('a');
+  g.InsertNode('e');
+  g.InsertEdge('a', 'b', 10);
+  g.InsertEdge('a', 'b', 1);
+  g.InsertEdge('a', 'd', 4);
+  g.InsertEdge('a', 'd', 50);
+  g.InsertEdge('b', 'b', 2);
+  g.InsertEdge('c', 'b', 3);
+  g.InsertEdge('b', 'c', 2);
+  g.InsertEdge('d', 'b', 23);
+  g.InsertEdge('d', 'd', 5);
+  return g;
+}
+
+std::string savePath(const std::string& name) {
+  return std::filesystem::temp_directory_path() / ("mapped_graph_test_" + name + ".gdwg");
+}
+
+}  // namespace
+
+SCENARIO("Mapping an empty graph") {
+  GIVEN("a saved empty graph") {
+    auto path = savePath("empty");
+    gdwg::Graph<char, int>{}.Save(path);
+
+    WHEN("it is mapped") {
+      gdwg::MappedGraph<char, int> mapped{path};
+
+      THEN("the mapped graph has no nodes or edges") {
+        CHECK(mapped.NodeCount() == 0);
+        CHECK(mapped.EdgeCount() == 0);
+        CHECK(mapped.GetNodes().empty());
+        CHECK_FALSE(mapped.IsNode('a'));
+        CHECK(mapped.begin() == mapped.end());
+        CHECK(mapped.rbegin() == mapped.rend());
+        CHECK(mapped.Verify());
+      }
+    }
+  }
+}
+
+SCENARIO("Querying a mapped graph") {
+  GIVEN("a saved graph") {
+    auto g = makeGraph();
+    auto path = savePath("query");
+    g.Save(path);
+
+    WHEN("it is mapped") {
+      gdwg::MappedGraph<char, int> mapped{path};
+
+      THEN("it answers queries the same way as the graph") {
+        CHECK(mapped.Verify());
+        CHECK(mapped.GetNodes() == g.GetNodes());
+        for (auto src : g.GetNodes()) {
+          CHECK(mapped.GetConnected(src) == g.GetConnected(src));
+          for (auto dst : g.GetNodes()) {
+            CHECK(mapped.IsConnected(src, dst) == g.IsConnected(src, dst));
+            CHECK(mapped.GetWeights(src, dst) == g.GetWeights(src, dst));
+          }
+        }
+        CHECK(mapped.IsNode('e'));
+        CHECK_FALSE(mapped.IsNode('x'));
+      }
+
+      THEN("missing nodes throw the same way as the graph") {
+        CHECK_THROWS_AS(mapped.IsConnected('x', 'a'), std::runtime_error);
+        CHECK_THROWS_AS(mapped.GetConnected('x'), std::out_of_range);
+        CHECK_THROWS_AS(mapped.GetWeights('a', 'x'), std::out_of_range);
+      }
+
+      THEN("iteration gives the edges of the graph in both directions") {
+        std::vector<std::tuple<char, char, int>> expected{g.begin(), g.end()};
+        std::vector<std::tuple<char, char, int>> res{mapped.begin(), mapped.end()};
+        CHECK(res == expected);
+        std::vector<std::tuple<char, char, int>> reversed{mapped.rbegin(), mapped.rend()};
+        std::reverse(expected.begin(), expected.end());
+        CHECK(reversed == expected);
+      }
+
+      THEN("ids follow node order and out-edges are contiguous") {
+        auto a = mapped.GetId('a');
+        CHECK(a == 0);
+        CHECK(mapped.EdgeCount() == 9);
+        auto weights = mapped.GetOutWeights(a);
+        CHECK(std::vector<int>(weights.begin(), weights.end()) == std::vector<int>{1, 10, 4, 50});
+        CHECK(mapped.GetValue(mapped.GetOutDestinations(a)[3]) == 'd');
+        CHECK(mapped.GetOutDestinations(mapped.GetId('e')).empty());
+      }
+
+      AND_WHEN("it is moved") {
+        auto moved = std::move(mapped);
+
+        THEN("the new graph has the mapping") {
+          CHECK(moved.IsConnected('d', 'd'));
+          CHECK(moved.NodeCount() == 5);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Mapping files that can't be used") {
+  GIVEN("a saved graph") {
+    auto path = savePath("bad");
+    makeGraph().Save(path);
+
+    WHEN("it is mapped as a graph of another type") {
+      THEN("it is turned away") {
+        CHECK_THROWS_AS((gdwg::MappedGraph<char, double>{path}), std::runtime_error);
+        CHECK_THROWS_AS((gdwg::MappedGraph<int, int>{path}), std::runtime_error);
+      }
+    }
+
+    WHEN("the file is cut short") {
+      std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+      THEN("it is turned away") {
+        CHECK_THROWS_AS((gdwg::MappedGraph<char, int>{path}), std::runtime_error);
+      }
+    }
+
+    WHEN("the file is shorter than its header") {
+      std::filesystem::resize_file(path, 10);
+
+      THEN("it is turned away before the header is used") {
+        CHECK_THROWS_WITH((gdwg::MappedGraph<char, int>{path}),
+                          "Cannot open a MappedGraph on a file that isn't a saved graph of "
+                          "this type");
+      }
+    }
+
+    WHEN("an edge offset in the file is changed") {
+      // The offsets follow the header and the five nodes, each part padded to
+      // 64 bytes
+      std::uint64_t offset = 1000;
+      std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+      file.seekp(64 + 64 + 2 * sizeof(offset));
+      file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+      file.close();
+
+      THEN("it is turned away without reading past the edges") {
+        CHECK_THROWS_WITH((gdwg::MappedGraph<char, int>{path}),
+                          "Cannot open a MappedGraph on a corrupt file");
+      }
+    }
+
+    WHEN("a weight in the file is changed") {
+      gdwg::MappedGraph<char, int> before{path};
+      auto at = reinterpret_cast<const char*>(&before.GetOutWeights(0)[0]) -
+                reinterpret_cast<const char*>(&before.GetValue(0)) + 64;
+      std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+      file.seekp(at);
+      file.put(7);
+      file.close();
+      gdwg::MappedGraph<char, int> mapped{path};
+
+      THEN("it still maps, but fails Verify") {
+        CHECK(mapped.GetWeights('a', 'b') == std::vector<int>{7, 10});
+        CHECK_FALSE(mapped.Verify());
+      }
+    }
+  }
+
+  GIVEN("a path with no file") {
+    THEN("it is turned away") {
+      CHECK_THROWS_AS((gdwg::MappedGraph<char, int>{savePath("missing")}), std::runtime_error);
+    }
+  }
+}
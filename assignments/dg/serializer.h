@@ -0,0 +1,281 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_SERIALIZER_H_
+#define ASSIGNMENTS_DG_SERIALIZER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gdwg {
+
+/**
+ * 64-bit checksum of a stream of bytes. The bytes can be handed over in
+ * pieces of any size, and are hashed a word at a time.
+ */
+class Checksum {
+ public:
+  void Update(const void* data, std::size_t size) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    length_ += size;
+    // Finish the word left over from the last update
+    while (size > 0 && pendingBytes_ > 0) {
+      pending_ |= std::uint64_t{*bytes} << (8 * pendingBytes_);
+      ++bytes;
+      --size;
+      if (++pendingBytes_ == 8) {
+        Mix(pending_);
+        pending_ = 0;
+        pendingBytes_ = 0;
+      }
+    }
+    for (; size >= 8; bytes += 8, size -= 8) {
+      std::uint64_t word;
+      std::memcpy(&word, bytes, 8);
+      Mix(word);
+    }
+    for (; size > 0; ++bytes, --size) {
+      pending_ |= std::uint64_t{*bytes} << (8 * pendingBytes_++);
+    }
+  }
+
+  std::uint64_t Value() const {
+    auto h = state_ ^ (pending_ * K1) ^ length_;
+    h = (h ^ (h >> 33)) * K2;
+    return h ^ (h >> 29);
+  }
+
+ private:
+  static constexpr std::uint64_t K1 = 0x9e3779b97f4a7c15;
+  static constexpr std::uint64_t K2 = 0xc2b2ae3d27d4eb4f;
+
+  void Mix(std::uint64_t word) {
+    state_ ^= word * K1;
+    state_ = ((state_ << 31) | (state_ >> 33)) * K2;
+  }
+
+  std::uint64_t state_ = 0;
+  std::uint64_t pending_ = 0;
+  std::size_t pendingBytes_ = 0;
+  std::uint64_t length_ = 0;
+};
+
+/**
+ * Writes bytes to a file through a large buffer, keeping a checksum of
+ * everything written. Blocks bigger than the buffer are written directly.
+ * The checksum is taken a block at a time as blocks go out.
+ */
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::FILE* file) : file_{file}, buffer_{new char[BUFFER_SIZE]} {}
+
+  void WriteBytes(const void* data, std::size_t size) {
+    if (size == 0) {
+      return;
+    }
+    written_ += size;
+    if (size > BUFFER_SIZE - used_) {
+      Flush();
+      if (size > BUFFER_SIZE) {
+        Put(data, size);
+        return;
+      }
+    }
+    std::memcpy(buffer_.get() + used_, data, size);
+    used_ += size;
+  }
+
+  // Writes the bytes of a trivially copyable value
+  template <typename T>
+  void WriteValue(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    WriteBytes(&value, sizeof(T));
+  }
+
+  // Writes zeros up to the next multiple of alignment bytes from the start
+  void Align(std::size_t alignment) {
+    static const char zeros[64] = {};
+    while (written_ % alignment != 0) {
+      WriteBytes(zeros, std::min(alignment - written_ % alignment, sizeof(zeros)));
+    }
+  }
+
+  // Passes everything to the file, followed by its checksum
+  void Finish() {
+    Flush();
+    auto sum = checksum_.Value();
+    Put(&sum, sizeof(sum));
+  }
+
+ private:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+  void Flush() {
+    Put(buffer_.get(), used_);
+    used_ = 0;
+  }
+
+  void Put(const void* data, std::size_t size) {
+    checksum_.Update(data, size);
+    if (std::fwrite(data, 1, size, file_) != size) {
+      throw std::runtime_error("Cannot write a graph to a file that can't be written");
+    }
+  }
+
+  std::FILE* file_;
+  std::unique_ptr<char[]> buffer_;
+  std::size_t used_ = 0;
+  std::uint64_t written_ = 0;
+  Checksum checksum_;
+};
+
+/**
+ * Reads bytes from a file through a large buffer, keeping a checksum of
+ * everything read. Blocks bigger than the buffer are read directly into
+ * place. The checksum is taken a span of the buffer at a time. Running out
+ * of file throws std::runtime_error.
+ */
+class BinaryReader {
+ public:
+  explicit BinaryReader(std::FILE* file) : file_{file}, buffer_{new char[BUFFER_SIZE]} {}
+
+  void ReadBytes(void* data, std::size_t size) {
+    read_ += size;
+    auto out = static_cast<char*>(data);
+    auto buffered = std::min(size, end_ - next_);
+    if (buffered > 0) {
+      std::memcpy(out, buffer_.get() + next_, buffered);
+      next_ += buffered;
+    }
+    if (buffered == size) {
+      return;
+    }
+    out += buffered;
+    size -= buffered;
+    Sync();
+    if (size >= BUFFER_SIZE) {
+      Get(out, size);
+      checksum_.Update(out, size);
+    } else {
+      end_ = std::fread(buffer_.get(), 1, BUFFER_SIZE, file_);
+      next_ = 0;
+      hashed_ = 0;
+      if (end_ < size) {
+        throw std::runtime_error("Cannot read past the end of a saved graph");
+      }
+      std::memcpy(out, buffer_.get(), size);
+      next_ = size;
+    }
+  }
+
+  // Reads the bytes of a trivially copyable value
+  template <typename T>
+  T ReadValue() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    ReadBytes(&value, sizeof(T));
+    return value;
+  }
+
+  // Skips the bytes written by BinaryWriter::Align
+  void Align(std::size_t alignment) {
+    char skipped[64];
+    while (read_ % alignment != 0) {
+      ReadBytes(skipped, std::min(alignment - read_ % alignment, sizeof(skipped)));
+    }
+  }
+
+  // Reads the checksum written by BinaryWriter::Finish, returns true if it
+  // matches what was read and nothing follows it
+  bool Finish() {
+    Sync();
+    auto expected = checksum_.Value();
+    auto sum = ReadValue<std::uint64_t>();
+    return sum == expected && next_ == end_ && std::fgetc(file_) == EOF;
+  }
+
+ private:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+  // Adds the bytes read from the buffer since the last call to the checksum
+  void Sync() {
+    checksum_.Update(buffer_.get() + hashed_, next_ - hashed_);
+    hashed_ = next_;
+  }
+
+  void Get(void* data, std::size_t size) {
+    if (std::fread(data, 1, size, file_) != size) {
+      throw std::runtime_error("Cannot read past the end of a saved graph");
+    }
+  }
+
+  std::FILE* file_;
+  std::unique_ptr<char[]> buffer_;
+  // buffer_[0, end_) was read from the file, and [0, next_) of that handed
+  // out, of which [0, hashed_) is in checksum_
+  std::size_t next_ = 0;
+  std::size_t end_ = 0;
+  std::size_t hashed_ = 0;
+  std::uint64_t read_ = 0;
+  Checksum checksum_;
+};
+
+/**
+ * How Graph::Save and Graph::Load store node values and weights of type T.
+ * Specialise it for other types with
+ *
+ *   static constexpr bool BITWISE = false;
+ *   static void Write(BinaryWriter& out, const T& value);
+ *   static T Read(BinaryReader& in);
+ *
+ * A serializer that is BITWISE stores a value as its sizeof(T) bytes, so
+ * whole columns of values can be copied at once.
+ */
+template <typename T, typename Enable = void>
+struct Serializer;
+
+// Trivially copyable values are stored as they are in memory
+template <typename T>
+struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T> &&
+                                      std::is_default_constructible_v<T>>> {
+  static constexpr bool BITWISE = true;
+
+  static void Write(BinaryWriter& out, const T& value) { out.WriteValue(value); }
+
+  static T Read(BinaryReader& in) { return in.ReadValue<T>(); }
+};
+
+// Strings, including std::pmr::string, are stored as a length and their
+// characters
+template <typename C, typename Traits, typename Alloc>
+struct Serializer<std::basic_string<C, Traits, Alloc>> {
+  static constexpr bool BITWISE = false;
+
+  static void Write(BinaryWriter& out, const std::basic_string<C, Traits, Alloc>& value) {
+    out.WriteValue(static_cast<std::uint64_t>(value.size()));
+    out.WriteBytes(value.data(), value.size() * sizeof(C));
+  }
+
+  static std::basic_string<C, Traits, Alloc> Read(BinaryReader& in) {
+    std::basic_string<C, Traits, Alloc> value;
+    auto size = in.ReadValue<std::uint64_t>();
+    // Read in pieces, so a corrupt size runs out of file before memory
+    while (value.size() < size) {
+      auto done = value.size();
+      value.resize(done + std::min<std::uint64_t>(size - done, 1 << 16));
+      in.ReadBytes(value.data() + done, (value.size() - done) * sizeof(C));
+    }
+    return value;
+  }
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SERIALIZER_H_
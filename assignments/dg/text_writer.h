@@ -0,0 +1,98 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_TEXT_WRITER_H_
+#define ASSIGNMENTS_DG_TEXT_WRITER_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+namespace gdwg {
+
+/**
+ * Collects text in a fixed buffer and passes it on to a sink in large
+ * blocks, so nothing is allocated per token. Values are written as an
+ * ostream with default formatting would write them, with arithmetic values
+ * formatted by std::to_chars. Other values that aren't strings fall back to
+ * an ostream.
+ *
+ * sink(const char* data, std::size_t size) returns false if it failed, after
+ * which nothing more is written.
+ */
+template <typename Sink>
+class TextWriter {
+ public:
+  explicit TextWriter(Sink sink) : sink_{sink} {}
+
+  TextWriter(const TextWriter&) = delete;
+
+  TextWriter& operator=(const TextWriter&) = delete;
+
+  void Write(std::string_view text) {
+    if (text.size() > sizeof(buffer_) - used_) {
+      Flush();
+      if (text.size() > sizeof(buffer_)) {
+        ok_ = ok_ && sink_(text.data(), text.size());
+        return;
+      }
+    }
+    std::memcpy(buffer_ + used_, text.data(), text.size());
+    used_ += text.size();
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      Write(std::string_view{value ? "1" : "0"});
+    } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                         std::is_same_v<T, unsigned char>) {
+      char c = static_cast<char>(value);
+      Write(std::string_view{&c, 1});
+    } else if constexpr (std::is_arithmetic_v<T>) {
+      // Longer than any number to_chars writes with these formats
+      constexpr std::size_t MAX_NUMBER = 64;
+      if (sizeof(buffer_) - used_ < MAX_NUMBER) {
+        Flush();
+      }
+      std::to_chars_result res;
+      if constexpr (std::is_floating_point_v<T>) {
+        // An ostream's default is %g with a precision of 6
+        res = std::to_chars(buffer_ + used_, buffer_ + sizeof(buffer_), value,
+                            std::chars_format::general, 6);
+      } else {
+        res = std::to_chars(buffer_ + used_, buffer_ + sizeof(buffer_), value);
+      }
+      used_ = res.ptr - buffer_;
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      Write(std::string_view{value});
+    } else {
+      std::ostringstream os;
+      os << value;
+      Write(std::string_view{os.str()});
+    }
+  }
+
+  // Passes on everything written so far, returns false if any write failed
+  bool Flush() {
+    if (used_ > 0) {
+      ok_ = ok_ && sink_(buffer_, used_);
+      used_ = 0;
+    }
+    return ok_;
+  }
+
+ private:
+  Sink sink_;
+  bool ok_ = true;
+  std::size_t used_ = 0;
+  char buffer_[1 << 16];
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_TEXT_WRITER_H_
@@ -0,0 +1,42 @@
+/**
+ * Copyright [2019] Clive Chen, Vaishnavi Bapat
+ * zid - z5166040, z5075858
+ */
+#ifndef ASSIGNMENTS_DG_VIEW_H_
+#define ASSIGNMENTS_DG_VIEW_H_
+
+#include <cstddef>
+#include <iterator>
+
+namespace gdwg {
+
+/**
+ * A read-only [first, last) range over storage owned by a graph. Views are
+ * cheap to copy and never allocate, but are invalidated by any mutation of
+ * the graph they were taken from.
+ */
+template <typename Iterator>
+class View {
+ public:
+  View() = default;
+
+  View(Iterator first, Iterator last) : first_{first}, last_{last} {}
+
+  inline Iterator begin() const { return first_; }
+
+  inline Iterator end() const { return last_; }
+
+  inline std::size_t size() const { return std::distance(first_, last_); }
+
+  inline bool empty() const { return first_ == last_; }
+
+  inline decltype(auto) operator[](std::size_t i) const { return *std::next(first_, i); }
+
+ private:
+  Iterator first_{};
+  Iterator last_{};
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_VIEW_H_